@@ -33,6 +33,7 @@
 #include "board_statusled.h"
 #include "remoteconfig.h"
 #include "firmware/firmwareversion.h"
+#include "firmware/debug/debug_boottime.h"
 #include "software_version.h"
 #include "flashcodeinstall.h"
 #include "configstore.h"
@@ -102,25 +103,36 @@ int main() {
     }
 
     board::Init();
+    debug::boottime::Mark("board");
     Display display(4);
+    debug::boottime::Mark("display");
     ConfigStore config_store;
+    debug::boottime::Mark("configstore");
     network::Init();
+    debug::boottime::Mark("network");
     FirmwareVersion fw(kSoftwareVersion, __DATE__, __TIME__);
     FlashCodeInstall flashcode_install;
+    debug::boottime::Mark("flashcode");
 
     printf("Remote=%c, Key=%c\n", kIsNotRemote ? 'N' : 'Y', kIsNotKey ? 'N' : 'Y');
     fw.Print("Bootloader TFTP Server");
 
     RemoteConfig remote_config(remoteconfig::Output::CONFIG);
+    debug::boottime::Mark("remoteconfig");
 
     display.Printf(3, "Bootloader TFTP Srvr");
 
     board::statusled::SetMode(board::statusled::Mode::kFast);
     watchdog::Init();
 
+    debug::boottime::Mark("loop");
+    debug::boottime::Print();
+
     while (1) {
         watchdog::Feed();
         network::Run();
+        display.Run();
         board::Run();
+        board::Idle();
     }
 }
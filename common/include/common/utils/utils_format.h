@@ -0,0 +1,180 @@
+/**
+ * @file utils_format.h
+ *
+ */
+/* Copyright (C) 2026 by Arjan van Vught mailto:info@gd32-dmx.org
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef COMMON_UTILS_UTILS_FORMAT_H_
+#define COMMON_UTILS_UTILS_FORMAT_H_
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <type_traits>
+
+/*
+ * Compile-time check of a format string against the printf of lib-clib and
+ * the argument types: flags '0' or '-', width, precision (digits or '*'),
+ * 'l' and the conversions c d i u x X p s f %.
+ * A format which is not supported or does not match the arguments fails to
+ * compile, the error names one of the functions below.
+ */
+namespace common::format {
+namespace check {
+void UnsupportedConversion();
+void TooFewArguments();
+void TooManyArguments();
+void ArgumentTypeMismatch();
+
+enum Expect : uint32_t { kInt = (1U << 0), kLong = (1U << 1), kDouble = (1U << 2), kString = (1U << 3), kPointer = (1U << 4) };
+
+template <typename T> consteval uint32_t Accepts() {
+    using U = std::remove_cv_t<T>;
+    uint32_t accepts = 0;
+
+    if constexpr (std::is_integral_v<U> || std::is_enum_v<U>) {
+        if constexpr (sizeof(U) <= sizeof(int)) {
+            accepts |= kInt;
+        }
+        if constexpr (sizeof(U) <= sizeof(long)) {
+            accepts |= kLong;
+        }
+    } else if constexpr (std::is_floating_point_v<U>) {
+        accepts |= kDouble;
+    } else if constexpr (std::is_pointer_v<U>) {
+        if constexpr (std::is_same_v<std::remove_cv_t<std::remove_pointer_t<U>>, char>) {
+            accepts |= kString;
+        }
+        accepts |= kPointer;
+    } else if constexpr (std::is_null_pointer_v<U>) {
+        accepts |= kString | kPointer;
+    }
+
+    return accepts;
+}
+
+template <typename... Args> consteval void Check(const char* fmt) {
+    constexpr uint32_t kAccepts[] = {Accepts<Args>()..., 0};
+    constexpr uint32_t kCount = sizeof...(Args);
+    uint32_t index = 0;
+
+    auto next = [&](uint32_t expect) {
+        if (index == kCount) {
+            TooFewArguments();
+        }
+        if ((kAccepts[index++] & expect) == 0) {
+            ArgumentTypeMismatch();
+        }
+    };
+
+    while (*fmt != '\0') {
+        if (*fmt++ != '%') {
+            continue;
+        }
+
+        if ((*fmt == '0') || (*fmt == '-')) {
+            fmt++;
+        }
+
+        while ((*fmt >= '0') && (*fmt <= '9')) {
+            fmt++;
+        }
+
+        if (*fmt == '.') {
+            fmt++;
+            if (*fmt == '*') {
+                fmt++;
+                next(kInt);
+            } else {
+                while ((*fmt >= '0') && (*fmt <= '9')) {
+                    fmt++;
+                }
+            }
+        }
+
+        const auto kIsLong = (*fmt == 'l');
+
+        if (kIsLong) {
+            fmt++;
+        }
+
+        switch (*fmt++) {
+            case 'c':
+            case 'd':
+            case 'i':
+            case 'u':
+            case 'x':
+            case 'X':
+                next(kIsLong ? kLong : kInt);
+                break;
+            case 'f':
+#if defined(DISABLE_PRINTF_FLOAT)
+                UnsupportedConversion();
+#endif
+                next(kDouble);
+                break;
+            case 'p':
+                next(kPointer);
+                break;
+            case 's':
+                next(kString);
+                break;
+            case '%':
+                break;
+            default:
+                UnsupportedConversion();
+                break;
+        }
+    }
+
+    if (index != kCount) {
+        TooManyArguments();
+    }
+}
+
+template <typename... Args> class String {
+   public:
+    template <typename S>
+        requires std::is_convertible_v<const S&, const char*>
+    consteval String(const S& fmt) : fmt_(fmt) { // NOLINT: implicit by design
+        Check<Args...>(fmt_);
+    }
+
+    constexpr const char* Get() const { return fmt_; }
+
+   private:
+    const char* fmt_;
+};
+} // namespace check
+
+template <typename... Args> using String = check::String<std::type_identity_t<Args>...>;
+
+template <typename... Args> inline int Printf(String<Args...> fmt, Args... args) {
+    return printf(fmt.Get(), args...);
+}
+
+template <typename... Args> inline int Snprintf(char* buffer, size_t size, String<Args...> fmt, Args... args) {
+    return snprintf(buffer, size, fmt.Get(), args...);
+}
+} // namespace common::format
+
+#endif // COMMON_UTILS_UTILS_FORMAT_H_
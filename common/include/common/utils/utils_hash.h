@@ -27,6 +27,7 @@
 #define COMMON_UTILS_UTILS_HASH_H_
 
 #include <cstdint>
+#include <cstddef>
 
 // Compile-time FNV-1a 32-bit hash
 consteval uint32_t Fnv1a32(const char* str, uint8_t length) {
@@ -48,4 +49,71 @@ inline uint32_t Fnv1a32Runtime(const char* str, uint32_t length) {
     return hash;
 }
 
+namespace common::hash {
+void NoPerfectHashFound();
+
+/*
+ * Compile-time perfect hash over the keys of a constant table.
+ * A key is the string up to (not including) kTerminator. The seed replaces
+ * the FNV-1a offset basis and is searched until all the keys land in their
+ * own slot, so a lookup is one hash and one slot read. The caller still
+ * compares the entry, the slot only tells which one.
+ */
+template <size_t N, char kTerminator> struct PerfectHash {
+    static constexpr uint32_t kSlots = [] {
+        uint32_t slots = 1;
+        while (slots < 2 * N) slots <<= 1;
+        return slots;
+    }();
+    static constexpr uint8_t kEmpty = 0xFF;
+    static_assert(N < kEmpty);
+
+    uint32_t seed;
+    uint8_t index[kSlots];
+
+    static constexpr uint32_t Hash(uint32_t seed, const char* key, uint32_t length) {
+        auto hash = seed;
+        for (uint32_t i = 0; (i < length) && (key[i] != kTerminator) && (key[i] != '\0'); ++i) {
+            hash ^= static_cast<uint8_t>(key[i]);
+            hash *= 0x01000193u;
+        }
+        return hash ^ (hash >> 16);
+    }
+
+    // Returns the table index of the candidate, N when there is none
+    constexpr uint32_t Find(const char* key, uint32_t length) const {
+        const auto kIndex = index[Hash(seed, key, length) & (kSlots - 1)];
+        return (kIndex == kEmpty) ? static_cast<uint32_t>(N) : kIndex;
+    }
+};
+
+template <char kTerminator, typename T, size_t N> consteval PerfectHash<N, kTerminator> MakePerfectHash(const T (&table)[N], const char* const T::*key) {
+    using Hash = PerfectHash<N, kTerminator>;
+    Hash hash{};
+
+    for (uint32_t seed = 0x811c9dc5u; seed < 0x811c9dc5u + 0x10000u; ++seed) {
+        hash.seed = seed;
+        for (auto& slot : hash.index) slot = Hash::kEmpty;
+
+        bool is_perfect = true;
+
+        for (size_t i = 0; i < N; ++i) {
+            auto& slot = hash.index[Hash::Hash(seed, table[i].*key, UINT32_MAX) & (Hash::kSlots - 1)];
+            if (slot != Hash::kEmpty) {
+                is_perfect = false;
+                break;
+            }
+            slot = static_cast<uint8_t>(i);
+        }
+
+        if (is_perfect) {
+            return hash;
+        }
+    }
+
+    NoPerfectHashFound();
+    return hash;
+}
+} // namespace common::hash
+
 #endif // COMMON_UTILS_UTILS_HASH_H_
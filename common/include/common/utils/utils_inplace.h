@@ -0,0 +1,77 @@
+/**
+ * @file utils_inplace.h
+ *
+ */
+/* Copyright (C) 2026 by Arjan van Vught mailto:info@gd32-dmx.org
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef COMMON_UTILS_UTILS_INPLACE_H_
+#define COMMON_UTILS_UTILS_INPLACE_H_
+
+#include <new>
+#include <utility>
+#include <cassert>
+
+namespace common {
+/*
+ * Storage for at most one T, constructed and destroyed in place.
+ * For a service which is started and stopped at run time: as a static object
+ * the storage is in .bss, so it never touches the heap and its size is in the
+ * linker map. std::optional is not freestanding in C++23.
+ */
+template <typename T> class InPlace {
+   public:
+    constexpr InPlace() = default;
+    ~InPlace() = default; ///< Trivial, so a static InPlace needs no atexit, Reset() destroys
+
+    InPlace(const InPlace&) = delete;
+    InPlace& operator=(const InPlace&) = delete;
+
+    template <typename... Args> T* Emplace(Args&&... args) {
+        assert(!has_value_);
+        auto* object = ::new (static_cast<void*>(storage_)) T(std::forward<Args>(args)...);
+        has_value_ = true;
+        return object;
+    }
+
+    void Reset() {
+        if (has_value_) {
+            Get()->~T();
+            has_value_ = false;
+        }
+    }
+
+    [[nodiscard]] bool HasValue() const { return has_value_; }
+
+    T* Get() {
+        assert(has_value_);
+        return std::launder(reinterpret_cast<T*>(storage_));
+    }
+
+    T* operator->() { return Get(); }
+
+   private:
+    alignas(T) unsigned char storage_[sizeof(T)];
+    bool has_value_{false};
+};
+} // namespace common
+
+#endif // COMMON_UTILS_UTILS_INPLACE_H_
@@ -0,0 +1,99 @@
+/**
+ * @file debug_boottime.h
+ *
+ */
+/* Copyright (C) 2026 by Arjan van Vught mailto:info@gd32-dmx.org
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef FIRMWARE_DEBUG_DEBUG_BOOTTIME_H_
+#define FIRMWARE_DEBUG_DEBUG_BOOTTIME_H_
+
+#include <cstdint>
+#include <cstdio>
+
+#include "timing.h"
+
+/*
+ * Boot phase tracer. Mark() records the end of a phase, the time is in
+ * microseconds since UdelayInit() in board::Init(). The first entry covers
+ * board::Init() itself.
+ */
+namespace debug::boottime {
+inline constexpr uint32_t kPhasesMax = 12;
+
+struct Phase {
+    const char* name;
+    uint32_t micros;
+};
+
+namespace implementation {
+inline Phase s_phases[kPhasesMax];
+inline uint32_t s_phases_count;
+} // namespace implementation
+
+inline void Mark(const char* name) {
+    using namespace implementation;
+
+    if (s_phases_count < kPhasesMax) {
+        s_phases[s_phases_count].name = name;
+        s_phases[s_phases_count].micros = timing::Micros();
+        s_phases_count++;
+    }
+}
+
+/**
+ * @brief One line per phase: name, end time and duration in microseconds.
+ * @return The number of characters written, excluding the terminating null.
+ */
+inline uint32_t Format(char* buffer, uint32_t size) {
+    using namespace implementation;
+
+    uint32_t length = 0;
+    uint32_t micros_previous = 0;
+
+    if (size != 0) {
+        buffer[0] = '\0'; // No phase marked
+    }
+
+    for (uint32_t i = 0; i < s_phases_count; i++) {
+        const auto& phase = s_phases[i];
+        const auto kLength = snprintf(&buffer[length], size - length, "%s %u +%u\n", phase.name, static_cast<unsigned>(phase.micros), static_cast<unsigned>(phase.micros - micros_previous));
+
+        if ((kLength < 0) || (static_cast<uint32_t>(kLength) >= (size - length))) {
+            buffer[length] = '\0'; // Drop the truncated line
+            break;
+        }
+
+        length += static_cast<uint32_t>(kLength);
+        micros_previous = phase.micros;
+    }
+
+    return length;
+}
+
+inline void Print() {
+    char buffer[kPhasesMax * 32];
+    Format(buffer, sizeof(buffer));
+    printf("Boot time [us]:\n%s", buffer);
+}
+} // namespace debug::boottime
+
+#endif // FIRMWARE_DEBUG_DEBUG_BOOTTIME_H_
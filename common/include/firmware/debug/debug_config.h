@@ -50,6 +50,12 @@ inline constexpr bool kStackMonitoringEnabled = true;
 #else
 inline constexpr bool kStackMonitoringEnabled = false;
 #endif
+
+#if defined(CONFIG_DEBUG_TIMELINE) // DWT cycle trace, debug_timeline.h
+inline constexpr bool kTimelineEnabled = true;
+#else
+inline constexpr bool kTimelineEnabled = false;
+#endif
 } // namespace debug::config
 
 #endif // FIRMWARE_DEBUG_DEBUG_CONFIG_H_
@@ -0,0 +1,194 @@
+/**
+ * @file debug_timeline.h
+ *
+ */
+/* Copyright (C) 2026 by Arjan van Vught mailto:info@gd32-dmx.org
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef FIRMWARE_DEBUG_DEBUG_TIMELINE_H_
+#define FIRMWARE_DEBUG_DEBUG_TIMELINE_H_
+
+#include <cstdint>
+#include <cstdio>
+
+#if defined(CONFIG_DEBUG_TIMELINE)
+extern "C" uint32_t SystemCoreClock; // CMSIS
+#endif
+
+/*
+ * Hot path tracer, enabled with CONFIG_DEBUG_TIMELINE. Each event is stored as
+ * the DWT cycle counter (enabled in UdelayInit()) in a RAM ring, the oldest
+ * events are overwritten. Recording costs a few cycles and no printf, so the
+ * timing of the traced code is hardly disturbed.
+ * Events are recorded from thread context only, there is no locking.
+ * The dump is decoded with common/scripts/timeline_decode.py.
+ */
+namespace debug::timeline {
+enum class Id : uint8_t {
+    kEmacRecv,  ///< emac::eth::Recv returned a frame
+    kUdpInput,  ///< network::udp::Input
+    kTftpInput, ///< TFTPDaemon::Input
+    kFlashWrite ///< FlashCode::Write
+};
+
+enum class Phase : uint8_t { kBegin, kEnd, kInstant };
+
+#if defined(CONFIG_DEBUG_TIMELINE)
+#if !defined(CONFIG_DEBUG_TIMELINE_ENTRIES)
+#define CONFIG_DEBUG_TIMELINE_ENTRIES 256
+#endif
+
+inline constexpr uint32_t kEntries = CONFIG_DEBUG_TIMELINE_ENTRIES;
+static_assert((kEntries & (kEntries - 1)) == 0, "CONFIG_DEBUG_TIMELINE_ENTRIES must be a power of 2");
+
+struct Entry {
+    uint32_t cycles;
+    Id id;
+    Phase phase;
+};
+
+namespace implementation {
+inline constexpr uint32_t kDwtCyccnt = 0xE0001004; ///< ARMv7-M DWT->CYCCNT
+inline Entry s_entries[kEntries];
+inline uint32_t s_head;
+inline bool s_enabled = true;
+} // namespace implementation
+
+inline void Record(Id id, Phase phase) {
+    using namespace implementation;
+
+    if (s_enabled) {
+        auto& entry = s_entries[s_head & (kEntries - 1)];
+        entry.cycles = *reinterpret_cast<volatile uint32_t*>(kDwtCyccnt);
+        entry.id = id;
+        entry.phase = phase;
+        s_head++;
+    }
+}
+
+/**
+ * @brief Stops recording, the ring is kept for the dump.
+ */
+inline void Stop() {
+    implementation::s_enabled = false;
+}
+
+/**
+ * @brief Clears the ring and (re)starts recording.
+ */
+inline void Start() {
+    implementation::s_head = 0;
+    implementation::s_enabled = true;
+}
+
+/**
+ * @brief Text dump, resumable over several buffers (datagrams).
+ *
+ * The first buffer starts with "timeline <cpu clock> <entries> <overwritten>",
+ * followed by one line per event: "<cycles hex> <id><B|E|I>", oldest first.
+ *
+ * @param index Entry to start with, 0 for the first buffer. Advanced past the written entries.
+ * @return The number of characters written, excluding the terminating null.
+ */
+inline uint32_t Format(char* buffer, uint32_t size, uint32_t& index) {
+    using namespace implementation;
+
+    const auto kCount = (s_head < kEntries) ? s_head : kEntries;
+    const auto kOldest = s_head - kCount;
+    uint32_t length = 0;
+
+    if (index == 0) {
+        const auto kLength = snprintf(buffer, size, "timeline %u %u %u\n", static_cast<unsigned>(SystemCoreClock), static_cast<unsigned>(kCount), static_cast<unsigned>(kOldest));
+        if ((kLength < 0) || (static_cast<uint32_t>(kLength) >= size)) {
+            return 0;
+        }
+        length = static_cast<uint32_t>(kLength);
+    }
+
+    static constexpr char kPhase[] = {'B', 'E', 'I'};
+
+    while (index < kCount) {
+        const auto& entry = s_entries[(kOldest + index) & (kEntries - 1)];
+        const auto kLength = snprintf(&buffer[length], size - length, "%08x %u%c\n", static_cast<unsigned>(entry.cycles), static_cast<unsigned>(entry.id), kPhase[static_cast<uint32_t>(entry.phase)]);
+
+        if ((kLength < 0) || (static_cast<uint32_t>(kLength) >= (size - length))) {
+            break;
+        }
+
+        length += static_cast<uint32_t>(kLength);
+        index++;
+    }
+
+    return length;
+}
+
+/**
+ * @return true when all entries have been formatted.
+ */
+inline bool Done(uint32_t index) {
+    using namespace implementation;
+    return index >= ((s_head < kEntries) ? s_head : kEntries);
+}
+
+inline void Print() {
+    char buffer[256];
+    uint32_t index = 0;
+
+    Stop();
+
+    do {
+        Format(buffer, sizeof(buffer), index);
+        printf("%s", buffer);
+    } while (!Done(index));
+
+    Start();
+}
+#else
+inline void Record([[maybe_unused]] Id id, [[maybe_unused]] Phase phase) {}
+inline void Stop() {}
+inline void Start() {}
+inline uint32_t Format([[maybe_unused]] char* buffer, [[maybe_unused]] uint32_t size, [[maybe_unused]] uint32_t& index) {
+    return 0;
+}
+inline bool Done([[maybe_unused]] uint32_t index) {
+    return true;
+}
+inline void Print() {}
+#endif
+
+inline void Mark(Id id) {
+    Record(id, Phase::kInstant);
+}
+
+class Scope {
+   public:
+    explicit Scope(Id id) : id_(id) { Record(id_, Phase::kBegin); }
+    ~Scope() { Record(id_, Phase::kEnd); }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+   private:
+    [[maybe_unused]] Id id_;
+};
+} // namespace debug::timeline
+
+#endif // FIRMWARE_DEBUG_DEBUG_TIMELINE_H_
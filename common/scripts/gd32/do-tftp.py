@@ -9,11 +9,14 @@ Usage:
   python3 do-tftp.py <ip_address> <file_to_put>
 
 Behavior matches the bash script:
-- toggles tftp on, waits until device responds and reports not Off
+- toggles tftp on, waits until device reports On
 - checks '?list#' for 'TFTP Server' and reboots if missing, then repeats enable
 - runs: tftp <ip> (binary, put <file>, quit)
-- toggles tftp off, waits until device responds and reports not On
+- toggles tftp off, waits until device reports Off
 - reboots and waits until '?list#' responds, then prints list and version
+
+The waits are '?wait#<ms>#tftp:On' requests, answered by the device when the
+state is reached. Firmware without '?wait#' is polled with '?tftp#'.
 """
 
 from __future__ import annotations
@@ -23,23 +26,23 @@ import subprocess
 import sys
 sys.dont_write_bytecode = True
 import time
-from typing import Optional
 
 import udp_send  # expects udp_send.py to be importable (same dir or PYTHONPATH)
 
 PORT = 10501
 BUFLEN = 512
 TIMEOUT_SEC = 1.0
+WAIT_MILLIS = 5000
 
 
-def _udp_cmd(ip: str, cmd: str) -> str:
+def _udp_cmd(ip: str, cmd: str, timeout_sec: float = TIMEOUT_SEC) -> str:
     """
     Send cmd via udp_send and return reply as text if any, else "".
     Mirrors: echo '...cmd...' | udp_send <ip>
     """
     data = cmd.encode("utf-8", errors="strict")
     _sent, reply = udp_send.send_and_maybe_recv(
-        ip, data, port=PORT, local_port=PORT, timeout_sec=TIMEOUT_SEC, buf_len=BUFLEN
+        ip, data, port=PORT, local_port=PORT, timeout_sec=timeout_sec, buf_len=BUFLEN
     )
     if not reply:
         return ""
@@ -50,38 +53,6 @@ def _sleep1() -> None:
     time.sleep(1.0)
 
 
-def _wait_nonempty_reply(ip: str, query_cmd: str, tick_cmd: Optional[str] = None) -> str:
-    """
-    Repeatedly:
-      optional send tick_cmd (e.g. '!tftp#1' or '!tftp#0')
-      query query_cmd (e.g. '?tftp#' or '?list#')
-    until reply != "".
-    """
-    reply = _udp_cmd(ip, query_cmd)
-    while reply == "":
-        _sleep1()
-        if tick_cmd is not None:
-            _udp_cmd(ip, tick_cmd)
-        reply = _udp_cmd(ip, query_cmd)
-    return reply
-
-
-def _wait_until_not_equal(ip: str, query_cmd: str, bad_value: str, tick_cmd: Optional[str] = None) -> str:
-    """
-    Wait until query reply is non-empty and != bad_value.
-    """
-    reply = _wait_nonempty_reply(ip, query_cmd, tick_cmd=tick_cmd)
-    while reply == bad_value:
-        _sleep1()
-        if tick_cmd is not None:
-            _udp_cmd(ip, tick_cmd)
-        reply = _udp_cmd(ip, query_cmd)
-        if reply == "":
-            # keep consistent with bash (it loops separately on empty)
-            reply = _wait_nonempty_reply(ip, query_cmd, tick_cmd=tick_cmd)
-    return reply
-
-
 def _reboot_and_wait_list(ip: str) -> str:
     print("Rebooting...")
     _udp_cmd(ip, "?reboot##")
@@ -93,33 +64,29 @@ def _reboot_and_wait_list(ip: str) -> str:
     return reply
 
 
-def _ensure_tftp_on(ip: str) -> str:
-    # initial kick
-    _udp_cmd(ip, "!tftp#1")
-    on_line = _udp_cmd(ip, "?tftp#")
-    print(f"[{on_line}]")
+def _ensure_tftp(ip: str, value: str, state: str) -> str:
+    """
+    Sends '!tftp#<value>' and blocks on the device until it reports state.
+    No reply while the device reboots or writes the flash, then the set is repeated.
+    """
+    while True:
+        _udp_cmd(ip, f"!tftp#{value}")
+        reply = _udp_cmd(ip, f"?wait#{WAIT_MILLIS}#{state}", timeout_sec=WAIT_MILLIS / 1000 + TIMEOUT_SEC)
+        if reply == "ERROR#?":
+            reply = _udp_cmd(ip, "?tftp#")
+            if reply != state:
+                _sleep1()
+        print(f"[{reply}]")
+        if reply == state:
+            return reply
 
-    # while empty: sleep 1, kick + query
-    on_line = _wait_nonempty_reply(ip, "?tftp#", tick_cmd="!tftp#1")
-    print(f"[{on_line}]")
 
-    # while "tftp:Off": sleep 1, kick + query
-    on_line = _wait_until_not_equal(ip, "?tftp#", "tftp:Off", tick_cmd="!tftp#1")
-    print(f"[{on_line}]")
-    return on_line
+def _ensure_tftp_on(ip: str) -> str:
+    return _ensure_tftp(ip, "1", "tftp:On")
 
 
 def _ensure_tftp_off(ip: str) -> str:
-    _udp_cmd(ip, "!tftp#0")
-    on_line = _udp_cmd(ip, "?tftp#")
-    print(f"[{on_line}]")
-
-    on_line = _wait_nonempty_reply(ip, "?tftp#", tick_cmd="!tftp#0")
-    print(f"[{on_line}]")
-
-    on_line = _wait_until_not_equal(ip, "?tftp#", "tftp:On", tick_cmd="!tftp#0")
-    print(f"[{on_line}]")
-    return on_line
+    return _ensure_tftp(ip, "0", "tftp:Off")
 
 
 def _run_tftp_put(ip: str, filename: str) -> None:
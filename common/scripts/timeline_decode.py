@@ -0,0 +1,162 @@
+#!/usr/bin/env python3
+"""
+timeline_decode.py
+
+Decodes the DWT cycle trace of debug_timeline.h (CONFIG_DEBUG_TIMELINE) into
+Chrome trace JSON, to be opened with chrome://tracing or https://ui.perfetto.dev
+
+The dump is read either from the device with the remote config request
+'?timeline#' (UDP port 10501), or from a file with the text captured from the
+UART after debug::timeline::Print().
+
+Dump format:
+  timeline <cpu clock> <entries> <overwritten>
+  <cycles hex> <id><B|E|I>
+
+The 32-bit cycle counter wraps (at 120 MHz after 35.8 s), the decoder assumes
+less than one wrap between consecutive events.
+
+Stand-alone:
+  python3 timeline_decode.py --ip <ip_address> [-o trace.json]
+  python3 timeline_decode.py uart.log [-o trace.json]
+"""
+
+from __future__ import annotations
+
+import argparse
+import json
+import socket
+import sys
+from typing import Iterable, List, Optional
+
+PORT = 10501
+BUFLEN = 1500
+DEFAULT_TIMEOUT_SEC = 0.5
+
+# Must match debug::timeline::Id
+EVENT_NAMES = ["emac::eth::Recv", "udp::Input", "TFTPDaemon::Input", "FlashCode::Write"]
+
+PHASES = {"B": "B", "E": "E", "I": "i"}
+
+
+def fetch(ip_address: str, timeout_sec: float = DEFAULT_TIMEOUT_SEC) -> str:
+    """Sends '?timeline#' and collects the reply datagrams until the device goes quiet."""
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM, socket.IPPROTO_UDP)
+    try:
+        sock.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+        sock.settimeout(timeout_sec)
+        sock.bind(("0.0.0.0", PORT))
+        sock.sendto(b"?timeline#", (ip_address, PORT))
+
+        chunks: List[bytes] = []
+        while True:
+            try:
+                data, _addr = sock.recvfrom(BUFLEN)
+            except socket.timeout:
+                break
+            chunks.append(data)
+
+        return b"".join(chunks).decode("ascii", errors="replace")
+    finally:
+        sock.close()
+
+
+def decode(lines: Iterable[str]) -> dict:
+    """Converts the dump lines into a Chrome trace object."""
+    clock_hz: Optional[int] = None
+    overwritten = 0
+    events = []
+    depth = [0] * len(EVENT_NAMES)
+    cycles_previous: Optional[int] = None
+    cycles_total = 0
+
+    for line in lines:
+        fields = line.split()
+
+        if len(fields) == 4 and fields[0] == "timeline":
+            clock_hz = int(fields[1])
+            overwritten = int(fields[3])
+            continue
+
+        if clock_hz is None or len(fields) != 2:
+            continue
+
+        try:
+            cycles = int(fields[0], 16)
+            event_id = int(fields[1][:-1])
+        except ValueError:
+            continue
+
+        phase = PHASES.get(fields[1][-1])
+        if phase is None:
+            continue
+
+        if cycles_previous is not None:
+            cycles_total += (cycles - cycles_previous) & 0xFFFFFFFF
+        cycles_previous = cycles
+
+        name = EVENT_NAMES[event_id] if event_id < len(EVENT_NAMES) else f"id {event_id}"
+
+        if event_id < len(depth):
+            # The begin of the oldest scopes can be overwritten in the ring
+            if phase == "E":
+                if depth[event_id] == 0:
+                    continue
+                depth[event_id] -= 1
+            elif phase == "B":
+                depth[event_id] += 1
+
+        event = {
+            "name": name,
+            "ph": phase,
+            "ts": cycles_total * 1e6 / clock_hz,
+            "pid": 0,
+            "tid": 0,
+        }
+        if phase == "i":
+            event["s"] = "t"
+        events.append(event)
+
+    if clock_hz is None:
+        raise ValueError("no 'timeline' header found")
+
+    return {
+        "traceEvents": events,
+        "displayTimeUnit": "ns",
+        "otherData": {"cpu_clock_hz": clock_hz, "overwritten": overwritten},
+    }
+
+
+def main(argv: list[str]) -> int:
+    parser = argparse.ArgumentParser(prog=argv[0], description="Decode the DWT cycle trace into Chrome trace JSON.")
+    source = parser.add_mutually_exclusive_group(required=True)
+    source.add_argument("--ip", help="fetch the trace from the device with '?timeline#'")
+    source.add_argument("file", nargs="?", help="UART capture, '-' for stdin")
+    parser.add_argument("-o", "--output", help="output file, default stdout")
+    args = parser.parse_args(argv[1:])
+
+    try:
+        if args.ip:
+            text = fetch(args.ip)
+        elif args.file == "-":
+            text = sys.stdin.read()
+        else:
+            with open(args.file, encoding="ascii", errors="replace") as f:
+                text = f.read()
+        trace = decode(text.splitlines())
+    except (OSError, ValueError) as e:
+        print(f"timeline_decode.py: {e}", file=sys.stderr)
+        return 1
+
+    if args.output:
+        with open(args.output, "w", encoding="ascii") as f:
+            json.dump(trace, f, indent=1)
+    else:
+        json.dump(trace, sys.stdout, indent=1)
+        sys.stdout.write("\n")
+
+    return 0
+
+
+if __name__ == "__main__":
+    raise SystemExit(main(sys.argv))
@@ -0,0 +1,229 @@
+#!/usr/bin/env python3
+"""
+uart_deferred_decode.py
+
+Expands the deferred printf records of uart0 (CONFIG_USART0_TX_DEFERRED) into
+text. The UART stream is text mixed with binary records:
+  0x00, payload length, format string address (4 bytes, little endian), payload
+
+The payload has a 32-bit little endian word per argument (and per '*'
+precision), a double for %f and the characters of %s including the null.
+The format strings are read from the ELF file of the firmware.
+
+Stand-alone:
+  python3 uart_deferred_decode.py <firmware.elf> <capture.bin>
+  python3 uart_deferred_decode.py <firmware.elf> --port /dev/ttyUSB0 [--baud 115200]
+"""
+
+from __future__ import annotations
+
+import argparse
+import struct
+import sys
+from typing import BinaryIO, Dict, List, Optional, Tuple
+
+
+class Elf:
+    """Minimal ELF reader: the allocated sections, to read strings by address."""
+
+    def __init__(self, path: str) -> None:
+        with open(path, "rb") as f:
+            self.data = f.read()
+
+        if self.data[:4] != b"\x7fELF":
+            raise ValueError(f"{path}: not an ELF file")
+
+        is_64 = self.data[4] == 2
+        endian = "<" if self.data[5] == 1 else ">"
+
+        if is_64:
+            shoff, = struct.unpack_from(endian + "Q", self.data, 0x28)
+            shentsize, shnum = struct.unpack_from(endian + "HH", self.data, 0x3A)
+            section = endian + "IIQQQQIIQQ"
+        else:
+            shoff, = struct.unpack_from(endian + "I", self.data, 0x20)
+            shentsize, shnum = struct.unpack_from(endian + "HH", self.data, 0x2E)
+            section = endian + "IIIIIIIIII"
+
+        SHT_NOBITS = 8
+        SHF_ALLOC = 2
+
+        self.sections: List[Tuple[int, int, int]] = []
+        for i in range(shnum):
+            fields = struct.unpack_from(section, self.data, shoff + i * shentsize)
+            sh_type, sh_flags, sh_addr, sh_offset, sh_size = fields[1], fields[2], fields[3], fields[4], fields[5]
+            if (sh_flags & SHF_ALLOC) and sh_type != SHT_NOBITS and sh_size > 0:
+                self.sections.append((sh_addr, sh_offset, sh_size))
+
+    def string(self, address: int) -> Optional[str]:
+        for sh_addr, sh_offset, sh_size in self.sections:
+            if sh_addr <= address < sh_addr + sh_size:
+                start = sh_offset + address - sh_addr
+                end = self.data.find(b"\0", start, sh_offset + sh_size)
+                if end < 0:
+                    return None
+                return self.data[start:end].decode("latin-1")
+        return None
+
+
+class Payload:
+    def __init__(self, data: bytes) -> None:
+        self.data = data
+        self.offset = 0
+
+    def word(self) -> int:
+        value, = struct.unpack_from("<I", self.data, self.offset)
+        self.offset += 4
+        return value
+
+    def double(self) -> float:
+        value, = struct.unpack_from("<d", self.data, self.offset)
+        self.offset += 8
+        return value
+
+    def string(self) -> str:
+        end = self.data.index(b"\0", self.offset)
+        value = self.data[self.offset:end].decode("latin-1")
+        self.offset = end + 1
+        return value
+
+
+def expand(fmt: str, payload: Payload) -> str:
+    """Formats as the printf of lib-clib, which the target would have used."""
+    out: List[str] = []
+    i = 0
+
+    while i < len(fmt):
+        if fmt[i] != "%":
+            out.append(fmt[i])
+            i += 1
+            continue
+
+        i += 1
+        flag = ""
+        if i < len(fmt) and fmt[i] in "0-":
+            flag = fmt[i]
+            i += 1
+
+        width = ""
+        while i < len(fmt) and fmt[i].isdigit():
+            width += fmt[i]
+            i += 1
+
+        precision: Optional[int] = None
+        if i < len(fmt) and fmt[i] == ".":
+            i += 1
+            if i < len(fmt) and fmt[i] == "*":
+                i += 1
+                precision = abs(struct.unpack("<i", struct.pack("<I", payload.word()))[0])
+            else:
+                digits = ""
+                while i < len(fmt) and fmt[i].isdigit():
+                    digits += fmt[i]
+                    i += 1
+                precision = int(digits) if digits else 0
+
+        if i < len(fmt) and fmt[i] == "l":
+            i += 1
+
+        conversion = fmt[i] if i < len(fmt) else ""
+        spec = ("<" if flag == "-" else "") + ("0" if flag == "0" else "") + width
+
+        if conversion in ("d", "i"):
+            value = struct.unpack("<i", struct.pack("<I", payload.word()))[0]
+            out.append(format(value, spec + "d"))
+        elif conversion == "u":
+            out.append(format(payload.word(), spec + "d"))
+        elif conversion in ("x", "X"):
+            out.append(format(payload.word(), spec + conversion))
+        elif conversion == "p":
+            out.append("0x" + format(payload.word(), "x"))
+        elif conversion == "c":
+            out.append(chr(payload.word() & 0xFF))
+        elif conversion == "s":
+            value = payload.string()
+            if precision is not None:
+                value = value[:precision]
+            out.append(format(value, ("<" if flag == "-" else ">") + width))
+        elif conversion == "f":
+            out.append(format(payload.double(), spec + "." + str(6 if precision is None else precision) + "f"))
+        elif conversion == "%":
+            out.append("%")
+        else:
+            # Not a conversion, the character is printed and examined again
+            out.append(conversion)
+            continue
+
+        i += 1
+
+    return "".join(out)
+
+
+def decode(elf: Elf, stream: BinaryIO, output) -> None:
+    cache: Dict[int, Optional[str]] = {}
+
+    while True:
+        c = stream.read(1)
+        if not c:
+            break
+
+        if c != b"\0":
+            output.write(c.decode("latin-1"))
+            continue
+
+        header = stream.read(5)
+        if len(header) < 5:
+            break
+        length = header[0]
+        address, = struct.unpack("<I", header[1:5])
+        payload = stream.read(length)
+
+        if address not in cache:
+            cache[address] = elf.string(address)
+        fmt = cache[address]
+
+        if fmt is None:
+            output.write(f"<format 0x{address:08x} not found>\n")
+            continue
+
+        try:
+            output.write(expand(fmt, Payload(payload)))
+        except (struct.error, ValueError):
+            output.write(f"<bad record for '{fmt.strip()}'>\n")
+
+        output.flush()
+
+
+def main(argv: list[str]) -> int:
+    parser = argparse.ArgumentParser(prog=argv[0], description="Expand the deferred printf records of uart0.")
+    parser.add_argument("elf", help="firmware ELF file")
+    source = parser.add_mutually_exclusive_group(required=True)
+    source.add_argument("capture", nargs="?", help="binary UART capture, '-' for stdin")
+    source.add_argument("--port", help="serial port, needs pyserial")
+    parser.add_argument("--baud", type=int, default=115200)
+    args = parser.parse_args(argv[1:])
+
+    try:
+        elf = Elf(args.elf)
+
+        if args.port:
+            import serial  # pylint: disable=import-outside-toplevel
+
+            with serial.Serial(args.port, args.baud) as port:
+                decode(elf, port, sys.stdout)
+        elif args.capture == "-":
+            decode(elf, sys.stdin.buffer, sys.stdout)
+        else:
+            with open(args.capture, "rb") as f:
+                decode(elf, f, sys.stdout)
+    except (OSError, ValueError, ImportError) as e:
+        print(f"uart_deferred_decode.py: {e}", file=sys.stderr)
+        return 1
+    except KeyboardInterrupt:
+        pass
+
+    return 0
+
+
+if __name__ == "__main__":
+    raise SystemExit(main(sys.argv))
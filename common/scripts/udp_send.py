@@ -5,7 +5,7 @@ udp_send.py
 Matches the behavior of the provided udp_send.c:
 - bind local UDP port 10501 on INADDR_ANY
 - send up to 512 bytes read from stdin to <ip>:10501
-- if first byte is '?', wait up to 1 second for a reply and print it
+- if first byte is '?' (query) or '*' (batch), wait up to 1 second for a reply and print it
 
 Stand-alone:
   python3 udp_send.py <ip_address> < payload.bin
@@ -53,7 +53,7 @@ def send_and_maybe_recv(
     Returns:
       (sent_len, reply_bytes_or_None)
 
-    If data starts with b'?', it will attempt to receive one reply up to `timeout_sec`.
+    If data starts with b'?' or b'*', it will attempt to receive one reply up to `timeout_sec`.
     If timeout happens, reply is None.
     """
     if not isinstance(data, (bytes, bytearray, memoryview)):
@@ -74,7 +74,7 @@ def send_and_maybe_recv(
         sent = sock.sendto(payload, (ip_address, port))
 
         reply: Optional[bytes] = None
-        if payload[:1] == b"?":
+        if payload[:1] in (b"?", b"*"):
             try:
                 # MSG_WAITALL isn't necessary in Python for datagrams; recvfrom returns one datagram.
                 reply, _addr = sock.recvfrom(buf_len)
@@ -103,7 +103,7 @@ def main(argv: list[str]) -> int:
         print(f"udp_send.py: {e}", file=sys.stderr)
         return 1
 
-    if data[:1] == b"?" and reply is not None:
+    if data[:1] in (b"?", b"*") and reply is not None:
         # C code treats reply as text and prints it.
         # We'll write raw bytes to stdout to avoid encoding surprises.
         sys.stdout.buffer.write(reply)
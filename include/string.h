@@ -58,8 +58,22 @@ inline int memcmp(const void* s1, const void* s2, size_t n) // NOLINT
     return 0;
 }
 
+extern void* clib_memcpy(void* __restrict__ dest, const void* __restrict__ src, size_t n); // NOLINT
+
+/*
+ * Copies of less than 16 bytes are inlined, a constant size as word loads and
+ * stores. The others are done by lib-clib.
+ */
 inline void* memcpy(void* __restrict__ dest, const void* __restrict__ src, size_t n) // NOLINT
 {
+    if (__builtin_constant_p(n) && (n < 16)) {
+        return __builtin_memcpy(dest, src, n);
+    }
+
+    if (n >= 16) {
+        return clib_memcpy(dest, src, n);
+    }
+
     char* dp = (char*)dest;
     const char* sp = (const char*)src;
 
@@ -31,6 +31,9 @@
 #include "hwclock.h"
 #endif
 #include "configstore.h"
+#if defined(CONFIG_CLIB_USE_UART0)
+#include "uart0.h"
+#endif
 #include "gd32.h" // IWYU pragma: keep
 
 #if !defined(NO_EMAC)
@@ -55,6 +58,10 @@ bool Reboot() {
 #endif
     board::statusled::SetMode(board::statusled::Mode::kOffOff);
 
+#if defined(CONFIG_CLIB_USE_UART0) && defined(CONFIG_USART0_ENABLE_TX_DMA)
+    uart0::Flush();
+#endif
+
     NVIC_SystemReset();
 
     __builtin_unreachable();
@@ -0,0 +1,264 @@
+/**
+ * @file bench_malloc.cpp
+ *
+ * Host-side check for malloc_tlsf.cpp.
+ *
+ * A randomized run of malloc, free, realloc and calloc with a pattern in
+ * every live block, then the split and merge of neighbouring blocks, an
+ * allocation up to the sentinel and the 128 KB block cap. The heap is 256 KB,
+ * so the cap applies. Last the time per malloc/free pair is measured.
+ *
+ * On the host a word is 8 bytes, the block overhead and alignment are 8.
+ * The "Out of memory" lines of the sentinel and cap checks are expected.
+ */
+/* Copyright (C) 2026 by Arjan van Vught mailto:info@gd32-dmx.org
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <vector>
+
+#include "clib_malloc.h"
+
+// The linker script symbols of the firmware
+asm(".globl heap_low\n"
+    ".globl heap_top\n"
+    ".bss\n"
+    ".balign 8\n"
+    "heap_low: .space 262144\n"
+    "heap_top: .space 8\n"
+    ".text\n");
+
+namespace {
+constexpr size_t kBlockSizeMax = 128 * 1024;
+constexpr int kIterations = 200000;
+constexpr size_t kLiveMax = 40;
+
+int s_fails;
+
+void Expect(bool condition, const char* what) {
+    if (!condition) {
+        printf("FAIL: %s\n", what);
+        s_fails++;
+    }
+}
+
+heap_info Info() {
+    heap_info info;
+    clib_heap_get_info(&info);
+    return info;
+}
+
+struct Live {
+    unsigned char* p;
+    size_t n;
+    unsigned char v;
+};
+
+bool IsPattern(const Live& live) {
+    for (size_t i = 0; i < live.n; i++) {
+        if (live.p[i] != live.v) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void Fill(Live& live) {
+    live.v = static_cast<unsigned char>(rand());
+    memset(live.p, live.v, live.n);
+}
+
+void Randomized() {
+    std::vector<Live> live;
+    long out_of_memory = 0;
+
+    for (int i = 0; i < kIterations; i++) {
+        const auto kOperation = rand() % 4;
+
+        if (!live.empty() && ((kOperation == 0) || (live.size() >= kLiveMax))) {
+            const auto kIndex = static_cast<size_t>(rand()) % live.size();
+            Expect(IsPattern(live[kIndex]), "pattern before free");
+            clib_free(live[kIndex].p);
+            live[kIndex] = live.back();
+            live.pop_back();
+            continue;
+        }
+
+        if (!live.empty() && (kOperation == 1)) {
+            auto& l = live[static_cast<size_t>(rand()) % live.size()];
+            Expect(IsPattern(l), "pattern before realloc");
+            const auto kSize = 1 + static_cast<size_t>(rand() % 3000);
+            auto* p = static_cast<unsigned char*>(clib_realloc(l.p, kSize));
+
+            if (p == nullptr) {
+                out_of_memory++;
+                continue;
+            }
+
+            const auto kKept = (kSize < l.n) ? kSize : l.n;
+            l.p = p;
+            l.n = kKept;
+            Expect(IsPattern(l), "realloc keeps the contents");
+            Expect(clib_malloc_usable_size(p) >= kSize, "realloc usable size");
+            l.n = kSize;
+            Fill(l);
+            continue;
+        }
+
+        const auto kSize = (rand() % 8 == 0) ? 1 + static_cast<size_t>(rand() % 4000) : 1 + static_cast<size_t>(rand() % 128);
+        Live l{nullptr, kSize, 0};
+
+        if (kOperation == 2) {
+            l.p = static_cast<unsigned char*>(clib_calloc(1, kSize));
+            if (l.p != nullptr) {
+                Expect(IsPattern(l), "calloc zeroes");
+            }
+        } else {
+            l.p = static_cast<unsigned char*>(clib_malloc(kSize));
+        }
+
+        if (l.p == nullptr) {
+            out_of_memory++;
+            continue;
+        }
+
+        Expect((reinterpret_cast<uintptr_t>(l.p) & 3U) == 0, "alignment");
+        Expect(clib_malloc_usable_size(l.p) >= kSize, "usable size");
+        Fill(l);
+        live.push_back(l);
+    }
+
+    for (auto& l : live) {
+        Expect(IsPattern(l), "pattern before free");
+        clib_free(l.p);
+    }
+
+    printf("randomized: %d operations, %ld out of memory\n", kIterations, out_of_memory);
+}
+
+void SplitMerge(const heap_info& initial) {
+    auto* a = clib_malloc(256);
+    auto* b = clib_malloc(256);
+    auto* c = clib_malloc(256);
+
+    Expect((a != nullptr) && (b != nullptr) && (c != nullptr), "split: malloc");
+    Expect(Info().free_blocks == 1, "split: the tail stays one free block");
+
+    clib_free(b);
+    Expect(Info().free_blocks == 2, "merge: a freed block between used blocks");
+    clib_free(a);
+    Expect(Info().free_blocks == 2, "merge: with the next block");
+    clib_free(c);
+
+    const auto kInfo = Info();
+    Expect((kInfo.free_blocks == 1) && (kInfo.largest_free == initial.largest_free), "merge: with both neighbours");
+
+    printf("split/merge: done\n");
+}
+
+/*
+ * malloc rounds a request up to the next size class, the heap is filled with
+ * shrinking requests until even malloc(1) fails. Every block is written up to
+ * its usable size, the last one up to the sentinel.
+ */
+void Sentinel(const heap_info& initial) {
+    std::vector<void*> blocks;
+
+    for (size_t size = 4096; size != 0; size /= 2) {
+        void* p;
+
+        while ((p = clib_malloc(size)) != nullptr) {
+            memset(p, 0xA5, clib_malloc_usable_size(p));
+            blocks.push_back(p);
+        }
+    }
+
+    Expect(Info().largest_free < 32, "sentinel: heap full");
+
+    for (auto* p : blocks) {
+        clib_free(p);
+    }
+
+    const auto kInfo = Info();
+    Expect((kInfo.free_blocks == 1) && (kInfo.largest_free == initial.largest_free) && (kInfo.used == 0), "sentinel: free of the full heap");
+
+    printf("sentinel: %zu blocks\n", blocks.size());
+}
+
+void Cap(const heap_info& initial) {
+    Expect(initial.size <= kBlockSizeMax, "cap: heap size");
+    Expect(clib_malloc(kBlockSizeMax) == nullptr, "cap: malloc(128 KB)");
+
+    printf("cap: heap %zu bytes, largest free %zu bytes\n", initial.size, initial.largest_free);
+}
+
+double Measure() {
+    void* slots[32] = {};
+    constexpr int kPairs = 2000000;
+
+    const auto kStart = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < 2 * kPairs; i++) {
+        auto& slot = slots[rand() & 31];
+
+        if (slot != nullptr) {
+            clib_free(slot);
+            slot = nullptr;
+        } else {
+            slot = clib_malloc(16 + static_cast<size_t>(rand() & 255));
+        }
+    }
+
+    const auto kNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - kStart).count() / kPairs;
+
+    for (auto* slot : slots) {
+        clib_free(slot);
+    }
+
+    return kNs;
+}
+} // namespace
+
+int main() {
+    srand(1);
+
+    const auto kInitial = Info();
+    Expect((kInitial.free_blocks == 1) && (kInitial.used == 0), "initial heap");
+
+    Randomized();
+
+    const auto kInfo = Info();
+    Expect((kInfo.free_blocks == 1) && (kInfo.used == 0) && (kInfo.largest_free == kInitial.largest_free), "all freed: one free block");
+
+    SplitMerge(kInitial);
+    Sentinel(kInitial);
+    Cap(kInitial);
+
+    printf("malloc/free pair %.1f ns\n", Measure());
+    printf("%d fail(s)\n", s_fails);
+
+    return s_fails == 0 ? 0 : 1;
+}
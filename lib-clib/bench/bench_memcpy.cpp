@@ -0,0 +1,170 @@
+/**
+ * @file bench_memcpy.cpp
+ *
+ * Host-side benchmark for memcpy.cpp.
+ *
+ * All sizes 0..600 at all 8x8 alignments are checked for the copy and for
+ * writes outside the destination. Then the time per copy is measured for the
+ * sizes and alignments of the firmware: a TFTP block is 512 bytes with the
+ * source at +2 (the UDP payload is only halfword aligned), a UDP datagram up
+ * to 1400 bytes.
+ *
+ * Columns:
+ * - bytes: the inline byte loop <string.h> had before clib_memcpy;
+ * - clib: the inline tier of <string.h> forwarding to clib_memcpy.
+ * On the host the plain C burst is measured, not the LDM/STM assembly.
+ */
+/* Copyright (C) 2026 by Arjan van Vught mailto:info@gd32-dmx.org
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+
+extern "C" {
+void* bench_clib_memcpy(void*, const void*, size_t);
+#if defined(BENCH_BASELINE)
+void* base_memcpy(void*, const void*, size_t);
+#endif
+}
+
+namespace {
+constexpr int kIterations = 2000000;
+
+alignas(64) unsigned char s_source[4096];
+alignas(64) unsigned char s_destination[4096];
+
+// The previous <string.h> memcpy
+__attribute__((noinline)) void* Bytes(void* destination, const void* source, size_t n) {
+    auto* d = static_cast<char*>(destination);
+    const auto* s = static_cast<const char*>(source);
+
+    while (n-- != 0) {
+        *d++ = *s++;
+        asm volatile("" ::: "memory"); // Keep the compiler from vectorizing, the target has no SIMD
+    }
+
+    return destination;
+}
+
+// Mirrors the inline memcpy in <string.h>
+inline void* Clib(void* destination, const void* source, size_t n) {
+    if (__builtin_constant_p(n) && (n < 16)) {
+        return __builtin_memcpy(destination, source, n);
+    }
+
+    if (n >= 16) {
+        return bench_clib_memcpy(destination, source, n);
+    }
+
+    auto* d = static_cast<char*>(destination);
+    const auto* s = static_cast<const char*>(source);
+
+    while (n-- != 0) {
+        *d++ = *s++;
+    }
+
+    return destination;
+}
+
+int Check() {
+    int fails = 0;
+
+    for (size_t n = 0; n < 600; n++) {
+        for (size_t offset_destination = 0; offset_destination < 8; offset_destination++) {
+            for (size_t offset_source = 0; offset_source < 8; offset_source++) {
+                memset(s_destination, 0xEE, sizeof(s_destination));
+                Clib(s_destination + offset_destination, s_source + offset_source, n);
+
+                if ((memcmp(s_destination + offset_destination, s_source + offset_source, n) != 0) || (s_destination[offset_destination + n] != 0xEE) ||
+                    ((offset_destination != 0) && (s_destination[offset_destination - 1] != 0xEE))) {
+                    fails++;
+                }
+            }
+        }
+    }
+
+    printf("sizes 0..599, 8x8 alignments: %d fail(s)\n", fails);
+
+    return fails;
+}
+
+template <typename F> double Measure(F f, size_t offset_destination, size_t offset_source, size_t n) {
+    const auto kStart = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < kIterations; i++) {
+        f(s_destination + offset_destination, s_source + offset_source, n);
+        asm volatile("" ::"r"(s_destination) : "memory");
+    }
+
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - kStart).count() / kIterations;
+}
+
+struct Case {
+    const char* name;
+    size_t offset_destination;
+    size_t offset_source;
+    size_t n;
+};
+
+constexpr Case kCases[] = {
+    {"64 aligned", 0, 0, 64},       {"512 aligned", 0, 0, 512},    {"512 src+2 (TFTP)", 0, 2, 512},
+    {"1400 aligned (UDP)", 0, 0, 1400}, {"1400 src+2", 0, 2, 1400}, {"1400 src+1", 0, 1, 1400},
+};
+} // namespace
+
+int main() {
+    for (auto& c : s_source) {
+        c = static_cast<unsigned char>(rand());
+    }
+
+    const auto kFails = Check();
+
+    const auto kConstantBytes = Measure(
+        [](void* d, const void* s, size_t) {
+            auto* dp = static_cast<char*>(d);
+            const auto* sp = static_cast<const char*>(s);
+            for (int i = 0; i < 8; i++) {
+                dp[i] = sp[i];
+                asm volatile("" ::: "memory");
+            }
+            return d;
+        },
+        0, 0, 8);
+    const auto kConstantClib = Measure([](void* d, const void* s, size_t) { return Clib(d, s, 8); }, 0, 0, 8);
+
+    printf("%-20s bytes %7.1f  clib %7.1f ns\n", "8 constant (inline)", kConstantBytes, kConstantClib);
+
+    for (const auto& c : kCases) {
+        const auto kBytes = Measure(Bytes, c.offset_destination, c.offset_source, c.n);
+        const auto kClib = Measure([](void* d, const void* s, size_t n) { return Clib(d, s, n); }, c.offset_destination, c.offset_source, c.n);
+#if defined(BENCH_BASELINE)
+        const auto kBase = Measure(base_memcpy, c.offset_destination, c.offset_source, c.n);
+        printf("%-20s bytes %7.1f  baseline %7.1f  clib %7.1f ns\n", c.name, kBytes, kBase, kClib);
+#else
+        printf("%-20s bytes %7.1f  clib %7.1f ns\n", c.name, kBytes, kClib);
+#endif
+    }
+
+    return kFails == 0 ? 0 : 1;
+}
@@ -0,0 +1,176 @@
+/**
+ * @file bench_printf.cpp
+ *
+ * Host-side benchmark for printf.cpp.
+ *
+ * The clib snprintf is first compared with the host C library, including
+ * truncation at every buffer size. Then the time per call is measured for
+ * format strings taken from the firmware: the remote config list and version
+ * replies, numbers, hex and a log line through printf.
+ * The console output goes to a counting sink.
+ */
+/* Copyright (C) 2026 by Arjan van Vught mailto:info@gd32-dmx.org
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <chrono>
+
+#define IPSTR "%d.%d.%d.%d"
+
+extern "C" {
+int clib_printf(const char*, ...);
+int clib_snprintf(char*, size_t, const char*, ...);
+#if defined(BENCH_BASELINE)
+int base_printf(const char*, ...);
+int base_snprintf(char*, size_t, const char*, ...);
+#endif
+}
+
+namespace uart0 {
+volatile uint32_t g_count;
+
+void PutChar([[maybe_unused]] int c) {
+    g_count = g_count + 1;
+}
+
+void Write([[maybe_unused]] const char* s, uint32_t length) {
+    g_count = g_count + length;
+}
+} // namespace uart0
+
+namespace {
+int s_fails;
+volatile int s_sink;
+char s_buffer[128];
+
+constexpr int kIterations = 2000000;
+
+#define COMPARE(...)                                                                                                    \
+    do {                                                                                                                \
+        char clib[256], host[256];                                                                                      \
+        const auto kClib = clib_snprintf(clib, sizeof(clib), __VA_ARGS__);                                              \
+        const auto kHost = snprintf(host, sizeof(host), __VA_ARGS__);                                                   \
+        if ((kClib != kHost) || (strcmp(clib, host) != 0)) {                                                            \
+            s_fails++;                                                                                                  \
+            printf("FAIL %s: clib [%s] %d, host [%s] %d\n", #__VA_ARGS__, clib, kClib, host, kHost);                     \
+        }                                                                                                               \
+    } while (false)
+
+#define TRUNCATE(size, ...)                                                                                             \
+    do {                                                                                                                \
+        char clib[64], host[64];                                                                                        \
+        memset(clib, '#', sizeof(clib));                                                                                \
+        memset(host, '#', sizeof(host));                                                                                \
+        const auto kClib = clib_snprintf(clib, size, __VA_ARGS__);                                                      \
+        const auto kHost = snprintf(host, size, __VA_ARGS__);                                                           \
+        if ((kClib != kHost) || (memcmp(clib, host, sizeof(clib)) != 0)) {                                              \
+            s_fails++;                                                                                                  \
+            printf("FAIL size %d %s\n", static_cast<int>(size), #__VA_ARGS__);                                          \
+        }                                                                                                               \
+    } while (false)
+
+void Compare() {
+    COMPARE("hello");
+    COMPARE("%d", 0);
+    COMPARE("%d", -1);
+    COMPARE("%d", 2147483647);
+    COMPARE("%d", static_cast<int>(-2147483647 - 1));
+    COMPARE("%u", 4294967295U);
+    COMPARE("%u", 1000000000U);
+    COMPARE("%5d|%-5d|%05d|%05d", 42, 42, 42, -5);
+    COMPARE("%.3d|%8.3d|%.0d", 7, 7, 1);
+    COMPARE("%x %X %08x %2x %x", 0xdeadbeefU, 0xabcU, 0x12U, 0xfffU, 0U);
+    COMPARE("%s|%10s|%-10s|%.2s|%.*s", "abc", "abc", "abc", "abc", 1, "abc");
+    COMPARE("%c%c", 'a', 'b');
+    COMPARE("a %% b %d %%", 5);
+    COMPARE("%f|%.2f|%8.3f", 3.25, -1.5, 2.5);
+    COMPARE(IPSTR ",%s,%s,%u,%s\n", 192, 168, 2, 100, "Bootloader TFTP", "DMX", 4U, "name");
+
+    for (size_t size = 0; size < 20; size++) {
+        TRUNCATE(size, "%s-%d-%x", "abcdef", 123456, 0xbeefU);
+    }
+
+    printf("compare with host C library: %d fail(s)\n", s_fails);
+}
+
+template <typename F> double Measure(F f) {
+    const auto kStart = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < kIterations; i++) {
+        f(i);
+    }
+
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - kStart).count() / kIterations;
+}
+
+using Snprintf = int (*)(char*, size_t, const char*, ...);
+using Printf = int (*)(const char*, ...);
+
+struct Functions {
+    Snprintf snprintf;
+    Printf printf;
+};
+
+constexpr uint32_t kCases = 6;
+
+void Cases(const Functions& f, double* ns) {
+    ns[0] = Measure([&](int i) {
+        s_sink = s_sink + f.snprintf(s_buffer, sizeof(s_buffer), IPSTR ",%s,%s,%u,%s\n", 192, 168, i & 255, 100, "Bootloader TFTP", "Art-Net 4",
+                                     static_cast<unsigned>(i), "gd32-dmx node");
+    });
+    ns[1] = Measure([&](int) { s_sink = s_sink + f.snprintf(s_buffer, sizeof(s_buffer), "version:%s\n", "[V1.0] Jan  1 2026 12:00:00 Bootloader TFTP"); });
+    ns[2] = Measure([&](int i) {
+        s_sink = s_sink + f.snprintf(s_buffer, sizeof(s_buffer), "%u %u %u %u", 4000000000U - static_cast<unsigned>(i), 123456789U + static_cast<unsigned>(i),
+                                     99999U, static_cast<unsigned>(i));
+    });
+    ns[3] = Measure([&](int i) {
+        s_sink = s_sink + f.snprintf(s_buffer, sizeof(s_buffer), "%08x %02x", static_cast<unsigned>(i) * 2654435761U, static_cast<unsigned>(i) & 0xFFU);
+    });
+    ns[4] = Measure([&](int i) { s_sink = s_sink + f.printf("TFTPDaemon::Input: block %u, length %u\n", static_cast<unsigned>(i), 512U); });
+    ns[5] = Measure([&](int i) { s_sink = s_sink + f.snprintf(s_buffer, 16, "%s %u", "a long string that does not fit", static_cast<unsigned>(i)); });
+}
+
+constexpr const char* kNames[kCases] = {"list reply", "version reply", "%u x4", "%08x %02x", "log line printf", "truncated 16"};
+} // namespace
+
+int main() {
+    Compare();
+
+    double clib[kCases];
+    Cases({clib_snprintf, clib_printf}, clib);
+
+#if defined(BENCH_BASELINE)
+    double base[kCases];
+    Cases({base_snprintf, base_printf}, base);
+
+    for (uint32_t i = 0; i < kCases; i++) {
+        printf("%-16s baseline %6.1f ns  clib %6.1f ns  x%.2f\n", kNames[i], base[i], clib[i], base[i] / clib[i]);
+    }
+#else
+    for (uint32_t i = 0; i < kCases; i++) {
+        printf("%-16s clib %6.1f ns\n", kNames[i], clib[i]);
+    }
+#endif
+
+    return s_fails == 0 ? 0 : 1;
+}
@@ -0,0 +1,21 @@
+/**
+ * @file clib_malloc.h
+ *
+ * Host stub, replaces <malloc.h> in the renamed allocator sources.
+ */
+
+#ifndef CLIB_MALLOC_H_
+#define CLIB_MALLOC_H_
+
+#include "../../../include/malloc.h"
+
+extern "C" {
+void* clib_malloc(size_t);
+void clib_free(void*);
+void* clib_realloc(void*, size_t);
+void* clib_calloc(size_t, size_t);
+size_t clib_malloc_usable_size(void*);
+void clib_heap_get_info(struct heap_info*);
+}
+
+#endif // CLIB_MALLOC_H_
@@ -0,0 +1,14 @@
+/**
+ * @file watchdog.h
+ *
+ * Host stub.
+ */
+
+#ifndef WATCHDOG_H_
+#define WATCHDOG_H_
+
+namespace watchdog {
+inline void Feed() {}
+} // namespace watchdog
+
+#endif // WATCHDOG_H_
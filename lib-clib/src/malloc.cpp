@@ -40,10 +40,12 @@
 #include <cstdint>
 #include <cstdio>
 #include <cassert>
+#include <malloc.h>
 
 #include "watchdog.h"
 #include "ansi_colour.h"
 
+#if !defined(CONFIG_CLIB_MALLOC_TLSF)
 static void Error(const char* func, const char* str) {
 	printf("%s%s: %s%s\n", ansi::Colours::Fg::kRed, func, str, ansi::Colours::Fg::kDefault);
 }
@@ -84,7 +86,12 @@ static constexpr unsigned int kBlockMagic = 0x424C4D43;
 #include "rpi/malloc.h"
 #endif
 
-static size_t GetAllocated(void* ptr) {
+static size_t BlockFootprint(size_t size) {
+    return (sizeof(struct BlockHeader) + size + 15) & static_cast<size_t>(~15);
+}
+
+extern "C" {
+size_t malloc_usable_size(void* ptr) { // NOLINT
     if (ptr == nullptr) {
         return 0;
     }
@@ -100,7 +107,6 @@ static size_t GetAllocated(void* ptr) {
     return block_header->size;
 }
 
-extern "C" {
 void* malloc(size_t size) { // NOLINT
     struct BlockBucket* bucket;
 
@@ -128,10 +134,7 @@ void* malloc(size_t size) { // NOLINT
     } else {
         header = reinterpret_cast<struct BlockHeader*>(next_block);
 
-        const auto kT1 = sizeof(struct BlockHeader) + size;
-        const auto kT2 = (kT1 + 15) & static_cast<size_t>(~15);
-
-        auto* next = next_block + kT2;
+        auto* next = next_block + BlockFootprint(size);
 
         assert((reinterpret_cast<uintptr_t>(header) & 3U) == 0);
         assert((reinterpret_cast<uintptr_t>(next) & 3U) == 0);
@@ -193,6 +196,33 @@ void free(void* ptr) { // NOLINT
     }
 }
 
+void heap_get_info(struct heap_info* info) { // NOLINT
+    assert(info != nullptr);
+
+    info->size = static_cast<size_t>(block_limit - &heap_low);
+    info->free = static_cast<size_t>(block_limit - next_block);
+    info->largest_free = (info->free > sizeof(struct BlockHeader)) ? info->free - sizeof(struct BlockHeader) : 0;
+    info->free_blocks = (info->free != 0) ? 1 : 0;
+
+    // A block in a free list is only reused for its own bucket size
+    for (auto* bucket = s_block_bucket; bucket->size > 0; bucket++) {
+        for (auto* header = bucket->free_list; header != nullptr; header = header->next) {
+            info->free += BlockFootprint(header->size);
+            info->free_blocks++;
+
+            if (header->size > info->largest_free) {
+                info->largest_free = header->size;
+            }
+        }
+    }
+
+    info->used = info->size - info->free;
+    info->fragmentation = (info->free != 0) ? static_cast<unsigned int>(100U - ((info->largest_free * 100U) / info->free)) : 0;
+}
+}
+#endif // !defined(CONFIG_CLIB_MALLOC_TLSF)
+
+extern "C" {
 void* calloc(size_t n, size_t size) { // NOLINT
     if ((n == 0) || (size == 0)) {
         return nullptr;
@@ -236,9 +266,9 @@ void* realloc(void* ptr, size_t newsize) { // NOLINT
         return nullptr;
     }
 
-    auto current_size = GetAllocated(ptr);
+    const auto kCurrentSize = malloc_usable_size(ptr);
 
-    if (current_size >= newsize) {
+    if (kCurrentSize >= newsize) {
         return ptr;
     }
 
@@ -251,7 +281,7 @@ void* realloc(void* ptr, size_t newsize) { // NOLINT
         const auto* src32 = reinterpret_cast<const uint32_t*>(ptr);
         auto* dst32 = reinterpret_cast<uint32_t*>(newblk);
 
-        auto count = newsize;
+        auto count = kCurrentSize; // The old block is smaller
 
         while (count >= 4) {
             *dst32++ = *src32++;
@@ -265,7 +295,7 @@ void* realloc(void* ptr, size_t newsize) { // NOLINT
             *dst8++ = *src8++;
         }
 
-        assert((reinterpret_cast<uintptr_t>(dst8) - reinterpret_cast<uintptr_t>(newblk)) == newsize);
+        assert((reinterpret_cast<uintptr_t>(dst8) - reinterpret_cast<uintptr_t>(newblk)) == kCurrentSize);
 
         free(ptr);
     }
@@ -274,6 +304,7 @@ void* realloc(void* ptr, size_t newsize) { // NOLINT
 }
 }
 
+#if !defined(CONFIG_CLIB_MALLOC_TLSF)
 void DebugHeap() {
 #ifdef DEBUG_HEAP
     watchdog::Feed();
@@ -308,5 +339,6 @@ void DebugHeap() {
     }
 #endif
 }
+#endif // !defined(CONFIG_CLIB_MALLOC_TLSF)
 
 #pragma GCC diagnostic pop
\ No newline at end of file
@@ -0,0 +1,452 @@
+/**
+ * @file malloc_tlsf.cpp
+ *
+ */
+/* This code is inspired by:
+ *
+ * TLSF: A New Dynamic Memory Allocator for Real-Time Systems
+ * M. Masmano, I. Ripoll, A. Crespo, J. Real (ECRTS 2004)
+ * and the implementation by Matthew Conte, https://github.com/mattconte/tlsf
+ */
+/* Copyright (C) 2026 by Arjan van Vught mailto:info@gd32-dmx.org
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#if defined(CONFIG_CLIB_MALLOC_TLSF)
+
+#ifdef DEBUG_HEAP
+#undef NDEBUG
+#endif
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cassert>
+#include <malloc.h>
+
+#include "watchdog.h"
+#include "ansi_colour.h"
+
+/*
+ * Two level segregated fit: malloc and free are O(1), a freed block is merged
+ * with its free physical neighbours.
+ * The first level is the power of 2 of the size, the second level splits it in
+ * kSlCount linear classes. A bitmap per level finds a non-empty free list with
+ * a single bit scan. A request is rounded up to the next class, so any block in
+ * the list found is large enough.
+ *
+ * A block is its size word followed by the payload. When a block is free, the
+ * payload has the free list links and its last word is the prev_phys pointer of
+ * the next block. So the overhead of an allocated block is one word.
+ */
+
+static void Error(const char* func, const char* str) {
+    printf("%s%s: %s%s\n", ansi::Colours::Fg::kRed, func, str, ansi::Colours::Fg::kDefault);
+}
+
+#define ERROR(s) Error(__func__, (s))
+
+void DebugHeap();
+
+extern unsigned char heap_low; /* Defined by the linker */
+extern unsigned char heap_top; /* Defined by the linker */
+
+namespace {
+#if !defined(CONFIG_CLIB_TLSF_FL_MAX)
+#define CONFIG_CLIB_TLSF_FL_MAX 17 // Blocks up to 128 KB
+#endif
+
+constexpr uint32_t kAlignLog2 = (sizeof(uintptr_t) == 8) ? 3 : 2; ///< A word
+constexpr uint32_t kAlign = 1U << kAlignLog2;
+constexpr uint32_t kSlLog2 = 3;
+constexpr uint32_t kSlCount = 1U << kSlLog2;
+constexpr uint32_t kFlShift = kSlLog2 + kAlignLog2;
+constexpr uint32_t kFlMax = CONFIG_CLIB_TLSF_FL_MAX;
+constexpr uint32_t kFlCount = kFlMax - kFlShift + 1;
+constexpr uint32_t kSmallBlockSize = 1U << kFlShift;
+
+static_assert(kFlCount <= 32, "A 32-bit first level bitmap");
+
+constexpr uint32_t kFree = 1U << 0;
+constexpr uint32_t kPrevFree = 1U << 1;
+constexpr uint32_t kFlags = kFree | kPrevFree;
+
+struct Block {
+    Block* prev_phys; ///< Valid only when the previous block is free, in its payload
+    uintptr_t size;   ///< Payload size | kFlags
+    Block* next_free; ///< Valid only when free
+    Block* prev_free;
+};
+
+constexpr uint32_t kOverhead = sizeof(uintptr_t);
+constexpr uint32_t kPayloadOffset = offsetof(Block, size) + sizeof(uintptr_t);
+static_assert(offsetof(Block, size) == kOverhead, "prev_phys is the last word of the previous payload");
+constexpr uint32_t kBlockSizeMin = sizeof(Block) - sizeof(Block*);
+constexpr uint32_t kBlockSizeMax = 1U << kFlMax;
+
+struct Control {
+    uint32_t fl_bitmap;
+    uint32_t sl_bitmap[kFlCount];
+    Block* blocks[kFlCount][kSlCount];
+    Block* first;
+    uint32_t used;
+    bool is_initialized;
+};
+
+Control s_control;
+
+inline uint32_t Fls(uint32_t x) {
+    return 31U - static_cast<uint32_t>(__builtin_clz(x));
+}
+
+inline uint32_t Ffs(uint32_t x) {
+    return static_cast<uint32_t>(__builtin_ctz(x));
+}
+
+inline uint32_t Size(const Block* block) {
+    return static_cast<uint32_t>(block->size) & ~kFlags;
+}
+
+inline bool IsFree(const Block* block) {
+    return (block->size & kFree) != 0;
+}
+
+inline bool IsPrevFree(const Block* block) {
+    return (block->size & kPrevFree) != 0;
+}
+
+inline bool IsLast(const Block* block) {
+    return Size(block) == 0;
+}
+
+inline void* ToPtr(Block* block) {
+    return reinterpret_cast<unsigned char*>(block) + kPayloadOffset;
+}
+
+inline Block* FromPtr(void* ptr) {
+    return reinterpret_cast<Block*>(reinterpret_cast<unsigned char*>(ptr) - kPayloadOffset);
+}
+
+inline Block* NextPhys(Block* block) {
+    return reinterpret_cast<Block*>(reinterpret_cast<unsigned char*>(ToPtr(block)) + Size(block) - kOverhead);
+}
+
+/*
+ * Sets the free flag and makes the block known to its next neighbour.
+ */
+inline void MarkFree(Block* block) {
+    auto* next = NextPhys(block);
+    next->prev_phys = block;
+    next->size |= kPrevFree;
+    block->size |= kFree;
+}
+
+inline void MarkUsed(Block* block) {
+    NextPhys(block)->size &= ~kPrevFree;
+    block->size &= ~kFree;
+}
+
+inline void MappingInsert(uint32_t size, uint32_t& fl, uint32_t& sl) {
+    if (size < kSmallBlockSize) {
+        fl = 0;
+        sl = size / (kSmallBlockSize / kSlCount);
+    } else {
+        const auto kFl = Fls(size);
+        sl = (size >> (kFl - kSlLog2)) ^ kSlCount;
+        fl = kFl - (kFlShift - 1);
+    }
+}
+
+/*
+ * Rounds up to the next class, the first block of that list fits.
+ */
+inline void MappingSearch(uint32_t size, uint32_t& fl, uint32_t& sl) {
+    if (size >= kSmallBlockSize) {
+        size += (1U << (Fls(size) - kSlLog2)) - 1;
+    }
+    MappingInsert(size, fl, sl);
+}
+
+Block* SearchSuitable(uint32_t& fl, uint32_t& sl) {
+    auto sl_map = s_control.sl_bitmap[fl] & (~0U << sl);
+
+    if (sl_map == 0) {
+        const auto kFlMap = (fl + 1 < 32) ? (s_control.fl_bitmap & (~0U << (fl + 1))) : 0;
+
+        if (kFlMap == 0) {
+            return nullptr;
+        }
+
+        fl = Ffs(kFlMap);
+        sl_map = s_control.sl_bitmap[fl];
+    }
+
+    sl = Ffs(sl_map);
+    return s_control.blocks[fl][sl];
+}
+
+void RemoveFree(Block* block, uint32_t fl, uint32_t sl) {
+    auto* prev = block->prev_free;
+    auto* next = block->next_free;
+
+    if (next != nullptr) {
+        next->prev_free = prev;
+    }
+
+    if (prev != nullptr) {
+        prev->next_free = next;
+    } else {
+        s_control.blocks[fl][sl] = next;
+
+        if (next == nullptr) {
+            s_control.sl_bitmap[fl] &= ~(1U << sl);
+
+            if (s_control.sl_bitmap[fl] == 0) {
+                s_control.fl_bitmap &= ~(1U << fl);
+            }
+        }
+    }
+}
+
+void InsertFree(Block* block) {
+    uint32_t fl;
+    uint32_t sl;
+    MappingInsert(Size(block), fl, sl);
+
+    auto* head = s_control.blocks[fl][sl];
+
+    block->next_free = head;
+    block->prev_free = nullptr;
+
+    if (head != nullptr) {
+        head->prev_free = block;
+    }
+
+    s_control.blocks[fl][sl] = block;
+    s_control.sl_bitmap[fl] |= (1U << sl);
+    s_control.fl_bitmap |= (1U << fl);
+}
+
+void Remove(Block* block) {
+    uint32_t fl;
+    uint32_t sl;
+    MappingInsert(Size(block), fl, sl);
+    RemoveFree(block, fl, sl);
+}
+
+/*
+ * The whole heap is one free block, followed by a zero size sentinel. The
+ * prev_phys of the first block is before the heap, it is never accessed.
+ */
+void Init() {
+    auto low = (reinterpret_cast<uintptr_t>(&heap_low) + (kAlign - 1)) & ~static_cast<uintptr_t>(kAlign - 1);
+    const auto kTop = reinterpret_cast<uintptr_t>(&heap_top) & ~static_cast<uintptr_t>(kAlign - 1);
+
+    auto size = static_cast<uint32_t>(kTop - low) - (2 * kOverhead);
+
+    if (size > (kBlockSizeMax - kAlign)) {
+        size = kBlockSizeMax - kAlign;
+    }
+
+    auto* block = reinterpret_cast<Block*>(low - offsetof(Block, size));
+    block->size = size;
+
+    auto* sentinel = NextPhys(block);
+    sentinel->size = 0;
+
+    s_control.first = block;
+    MarkFree(block);
+    InsertFree(block);
+
+    s_control.is_initialized = true;
+}
+
+/*
+ * Splits off the tail of a block when it can hold a free block.
+ */
+void Trim(Block* block, uint32_t size) {
+    const auto kSize = Size(block);
+
+    if (kSize < (size + sizeof(Block))) {
+        return;
+    }
+
+    auto* remaining = reinterpret_cast<Block*>(reinterpret_cast<unsigned char*>(ToPtr(block)) + size - kOverhead);
+    remaining->size = kSize - size - kOverhead;
+    block->size = size | (block->size & kFlags);
+
+    MarkFree(remaining);
+    InsertFree(remaining);
+}
+
+Block* MergePrev(Block* block) {
+    if (IsPrevFree(block)) {
+        auto* prev = block->prev_phys;
+        assert(IsFree(prev));
+        Remove(prev);
+        prev->size += Size(block) + kOverhead;
+        block = prev;
+    }
+
+    return block;
+}
+
+Block* MergeNext(Block* block) {
+    auto* next = NextPhys(block);
+
+    if (IsFree(next)) {
+        assert(!IsLast(next));
+        Remove(next);
+        block->size += Size(next) + kOverhead;
+    }
+
+    return block;
+}
+} // namespace
+
+extern "C" {
+void* malloc(size_t size) { // NOLINT
+    if (size == 0) {
+        return nullptr;
+    }
+
+    if (__builtin_expect((!s_control.is_initialized), 0)) {
+        Init();
+    }
+
+    if (size > (kBlockSizeMax - kAlign)) {
+        ERROR("Out of memory\n");
+        return nullptr;
+    }
+
+    auto adjust = (static_cast<uint32_t>(size) + (kAlign - 1)) & ~(kAlign - 1);
+
+    if (adjust < kBlockSizeMin) {
+        adjust = kBlockSizeMin;
+    }
+
+    uint32_t fl;
+    uint32_t sl;
+    MappingSearch(adjust, fl, sl);
+
+    auto* block = (fl < kFlCount) ? SearchSuitable(fl, sl) : nullptr;
+
+    if (block == nullptr) {
+        ERROR("Out of memory\n");
+#ifdef DEBUG_HEAP
+        DebugHeap();
+#endif
+        return nullptr;
+    }
+
+    assert(Size(block) >= adjust);
+
+    RemoveFree(block, fl, sl);
+    Trim(block, adjust);
+    MarkUsed(block);
+
+    s_control.used += Size(block) + kOverhead;
+
+#ifdef DEBUG_HEAP
+    watchdog::Feed();
+    printf("malloc(%u): block=%p, size=%u, data=%p\n", static_cast<unsigned>(size), reinterpret_cast<void*>(block), static_cast<unsigned>(Size(block)), ToPtr(block));
+#endif
+
+    assert((reinterpret_cast<uintptr_t>(ToPtr(block)) & 3U) == 0);
+    return ToPtr(block);
+}
+
+void free(void* ptr) { // NOLINT
+    if (ptr == nullptr) {
+        return;
+    }
+
+    auto* block = FromPtr(ptr);
+
+#ifdef DEBUG_HEAP
+    watchdog::Feed();
+    printf("free: block=%p, p=%p, size=%u\n", reinterpret_cast<void*>(block), ptr, static_cast<unsigned>(Size(block)));
+#endif
+
+    assert(!IsFree(block));
+    if (IsFree(block)) {
+        ERROR("Double free\n");
+        return;
+    }
+
+    s_control.used -= Size(block) + kOverhead;
+
+    MarkFree(block);
+    block = MergePrev(block);
+    block = MergeNext(block);
+    MarkFree(block);
+    InsertFree(block);
+}
+
+size_t malloc_usable_size(void* ptr) { // NOLINT
+    if (ptr == nullptr) {
+        return 0;
+    }
+
+    return Size(FromPtr(ptr));
+}
+
+void heap_get_info(struct heap_info* info) { // NOLINT
+    assert(info != nullptr);
+
+    if (!s_control.is_initialized) {
+        Init();
+    }
+
+    info->size = 0;
+    info->free = 0;
+    info->largest_free = 0;
+    info->free_blocks = 0;
+
+    for (auto* block = s_control.first; !IsLast(block); block = NextPhys(block)) {
+        const auto kSize = Size(block);
+
+        info->size += kSize + kOverhead;
+
+        if (IsFree(block)) {
+            info->free += kSize;
+            info->free_blocks++;
+
+            if (kSize > info->largest_free) {
+                info->largest_free = kSize;
+            }
+        }
+    }
+
+    info->used = s_control.used;
+    info->fragmentation = (info->free != 0) ? static_cast<unsigned int>(100U - ((info->largest_free * 100U) / info->free)) : 0;
+}
+}
+
+void DebugHeap() {
+#ifdef DEBUG_HEAP
+    watchdog::Feed();
+
+    for (auto* block = s_control.first; !IsLast(block); block = NextPhys(block)) {
+        printf("\t %p:%p size %u %s\n", reinterpret_cast<void*>(block), ToPtr(block), static_cast<unsigned>(Size(block)), IsFree(block) ? "free" : "used");
+    }
+#endif
+}
+#endif // defined(CONFIG_CLIB_MALLOC_TLSF)
@@ -1,44 +1,96 @@
 #pragma GCC push_options
 #pragma GCC optimize("O3")
 #pragma GCC optimize("-fno-strict-aliasing")
+#pragma GCC optimize("no-tree-loop-distribute-patterns")
 
 #include <stddef.h>
 #include <stdint.h>
 
-extern "C" void* memcpy(void* dst, const void* src, size_t n) { // NOLINT
+/*
+ * The small copies are done inline by <string.h>, this is the large copy.
+ * - Source and destination with the same word alignment: 32 byte LDM/STM bursts.
+ * - Otherwise the destination is aligned and the source is read with unaligned
+ *   word loads (ARMv7-M), instead of byte by byte.
+ */
+
+static inline void CopyBurst(uint32_t*& dw, const uint32_t*& sw) {
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__)
+    asm volatile(
+        "ldmia %1!, {r3, r4, r5, r6, r8, r9, r10, r12}\n\t"
+        "stmia %0!, {r3, r4, r5, r6, r8, r9, r10, r12}"
+        : "+r"(dw), "+r"(sw)
+        :
+        : "r3", "r4", "r5", "r6", "r8", "r9", "r10", "r12", "memory");
+#else
+    const auto w0 = sw[0];
+    const auto w1 = sw[1];
+    const auto w2 = sw[2];
+    const auto w3 = sw[3];
+    const auto w4 = sw[4];
+    const auto w5 = sw[5];
+    const auto w6 = sw[6];
+    const auto w7 = sw[7];
+    dw[0] = w0;
+    dw[1] = w1;
+    dw[2] = w2;
+    dw[3] = w3;
+    dw[4] = w4;
+    dw[5] = w5;
+    dw[6] = w6;
+    dw[7] = w7;
+    dw += 8;
+    sw += 8;
+#endif
+}
+
+extern "C" void* clib_memcpy(void* dst, const void* src, size_t n) { // NOLINT
     unsigned char* d = (unsigned char*)dst;
     const unsigned char* s = (const unsigned char*)src;
 
-    // Align to word boundary
-    while (n && (((uintptr_t)d | (uintptr_t)s) & (sizeof(uint32_t) - 1))) {
-        *d++ = *s++;
-        --n;
-    }
+    if (n >= 16) {
+        // Align the destination to word boundary
+        while (((uintptr_t)d & (sizeof(uint32_t) - 1)) != 0) {
+            *d++ = *s++;
+            --n;
+        }
 
-    uint32_t* dw = (uint32_t*)d;
-    const uint32_t* sw = (const uint32_t*)s;
-
-    while (n >= 16) { // unroll
-        dw[0] = sw[0];
-        dw[1] = sw[1];
-        dw[2] = sw[2];
-        dw[3] = sw[3];
-        dw += 4;
-        sw += 4;
-        n -= 16;
-    }
+        uint32_t* dw = (uint32_t*)d;
 
-    while (n >= 4) {
-        *dw++ = *sw++;
-        n -= 4;
-    }
+        if (((uintptr_t)s & (sizeof(uint32_t) - 1)) == 0) {
+            const uint32_t* sw = (const uint32_t*)s;
 
-    d = (unsigned char*)dw;
-    s = (const unsigned char*)sw;
+            while (n >= 32) {
+                CopyBurst(dw, sw);
+                n -= 32;
+            }
+
+            while (n >= 4) {
+                *dw++ = *sw++;
+                n -= 4;
+            }
+
+            s = (const unsigned char*)sw;
+        } else {
+            while (n >= 4) {
+                uint32_t w;
+                __builtin_memcpy(&w, s, sizeof(uint32_t)); // Unaligned load
+                *dw++ = w;
+                s += 4;
+                n -= 4;
+            }
+        }
+
+        d = (unsigned char*)dw;
+    }
 
     while (n--) *d++ = *s++;
 
     return dst;
 }
 
-#pragma GCC pop_options
\ No newline at end of file
+// For the calls generated by the compiler
+extern "C" void* memcpy(void* dst, const void* src, size_t n) { // NOLINT
+    return clib_memcpy(dst, src, n);
+}
+
+#pragma GCC pop_options
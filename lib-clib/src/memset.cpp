@@ -36,6 +36,14 @@ extern "C" void* memset(void* dst, int val, size_t count) { // NOLINT
 
     /* Use 64-bit writes for as long as possible. */
     ptr64 = reinterpret_cast<uint64_t*>(ptr);
+    /* Bursts of 32 bytes (STM/STRD), then the remaining 64-bit words. */
+    for (; count >= 32U; count -= 32) {
+        ptr64[0] = fill;
+        ptr64[1] = fill;
+        ptr64[2] = fill;
+        ptr64[3] = fill;
+        ptr64 += 4;
+    }
     for (; count >= 8U; count -= 8) {
         *ptr64 = fill;
         ptr64++;
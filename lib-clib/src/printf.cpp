@@ -26,155 +26,268 @@
 #include <cstdint>
 #include <cstdarg>
 #include <cstddef>
-#include <cctype>
 #include <cstring>
 #include <climits>
 
 #if defined(CONFIG_CLIB_USE_UART0)
 namespace uart0 {
-void PutChar(int);
+void Write(const char*, uint32_t);
+#if defined(CONFIG_USART0_TX_DEFERRED)
+int Deferred(const char*, va_list);
+#endif
 } // namespace uart0
-using uart0::PutChar;
+static void ConsoleWrite(const char* s, uint32_t length) {
+    uart0::Write(s, length);
+}
 #elif defined(CONFIG_CLIB_USE_NULL)
-namespace {
-void PutChar([[maybe_unused]] int) {}
-} // namespace
-using ::PutChar;
+static void ConsoleWrite([[maybe_unused]] const char* s, [[maybe_unused]] uint32_t length) {}
 #else
 namespace console {
 void PutChar(int);
 } // namespace console
-using console::PutChar;
+static void ConsoleWrite(const char* s, uint32_t length) {
+    while (length-- != 0) {
+        console::PutChar(static_cast<int>(*s++));
+    }
+}
 #endif
 
+/*
+ * The output goes to a buffer: the one of sprintf/snprintf, or a chunk on the
+ * stack for printf which is written to the console when full and at the end.
+ * Characters which do not fit in a snprintf buffer are only counted.
+ */
 struct Context {
+    char* out;
+    char* chunk; ///< nullptr for a sprintf/snprintf buffer
+    uint32_t available;
+    int total;
     int flag;
     int prec;
     int width;
-    int total;
-    int capacity;
 };
 
 enum { kFlagPrecision = (1U << 0), kFlagUppercase = (1U << 1), kFlagLong = (1U << 2), kFlagNegative = (1U << 3), kFlagMinWidth = (1U << 4), kFlagZeroPadded = (1U << 5), kFlagLeftJustified = (1U << 6) };
 
-static char* outptr = nullptr;
+static constexpr uint32_t kChunkSize = 64;
+
+static void Flush(struct Context* ctx) {
+    ConsoleWrite(ctx->chunk, static_cast<uint32_t>(ctx->out - ctx->chunk));
+    ctx->out = ctx->chunk;
+    ctx->available = kChunkSize;
+}
+
+/*
+ * @return The number of characters which can be stored, 0 when the rest is only counted.
+ */
+static inline uint32_t Reserve(struct Context* ctx) {
+    if (__builtin_expect((ctx->available == 0), 0)) {
+        if (ctx->chunk == nullptr) {
+            return 0;
+        }
+        Flush(ctx);
+    }
+
+    return ctx->available;
+}
 
-inline static void PutChar(struct Context* ctx, int c) {
+static inline void PutChar(struct Context* ctx, char c) {
     ctx->total++;
 
-    if (outptr != nullptr) {
-        if (ctx->total < ctx->capacity) {
-            *outptr++ = static_cast<char>(c);
+    if (Reserve(ctx) != 0) {
+        *ctx->out++ = c;
+        ctx->available--;
+    }
+}
+
+static void Write(struct Context* ctx, const char* s, int length) {
+    ctx->total += length;
+
+    auto remaining = static_cast<uint32_t>(length);
+
+    // Most fields are a few characters, a call to memcpy costs more than the copy
+    if ((remaining <= 8) && (remaining <= ctx->available)) {
+        ctx->available -= remaining;
+        while (remaining-- != 0) {
+            *ctx->out++ = *s++;
         }
         return;
     }
 
-    PutChar(c);
+    while (remaining != 0) {
+        auto count = Reserve(ctx);
+
+        if (count == 0) {
+            return;
+        }
+
+        if (count > remaining) {
+            count = remaining;
+        }
+
+        memcpy(ctx->out, s, count);
+        ctx->out += count;
+        ctx->available -= count;
+        s += count;
+        remaining -= count;
+    }
 }
 
-static void FormatHex(struct Context* ctx, unsigned int arg) {
-    char buffer[64];
-    char* p = buffer + (sizeof(buffer) / sizeof(buffer[0])) - 1;
-    char* o = p;
-    char alpha;
-    char u;
-    int i;
-
-    if (arg == 0) {
-        *p = '0';
-        p--;
-    } else {
-        alpha = ((ctx->flag & kFlagUppercase) != 0) ? static_cast<char>('A' - 10) : static_cast<char>('a' - 10);
-
-        do {
-            u = static_cast<char>(arg) & static_cast<char>(0x0F);
-            *p = (u < 10) ? static_cast<char>('0' + u) : static_cast<char>(alpha + u);
-            p--;
-            arg = arg >> 4;
-        } while ((arg != 0) && (p > buffer));
+static void Pad(struct Context* ctx, char c, int length) {
+    if (length <= 0) {
+        return;
     }
 
-    if ((ctx->flag & kFlagPrecision) != 0) {
-        while (((o - p) < ctx->prec) && (p > buffer)) {
-            *p-- = '0';
+    ctx->total += length;
+
+    auto remaining = static_cast<uint32_t>(length);
+
+    if ((remaining <= 8) && (remaining <= ctx->available)) {
+        ctx->available -= remaining;
+        while (remaining-- != 0) {
+            *ctx->out++ = c;
         }
+        return;
     }
 
-    if ((ctx->flag & kFlagZeroPadded) != 0) {
-        while (((o - p) < ctx->width) && (p > buffer)) {
-            *p-- = '0';
+    while (remaining != 0) {
+        auto count = Reserve(ctx);
+
+        if (count == 0) {
+            return;
         }
-    }
 
-    if ((ctx->flag & kFlagLeftJustified) == 0) {
-        while (((o - p) < ctx->width) && (p > buffer)) {
-            *p-- = ' ';
+        if (count > remaining) {
+            count = remaining;
         }
+
+        memset(ctx->out, c, count);
+        ctx->out += count;
+        ctx->available -= count;
+        remaining -= count;
     }
+}
 
-    i = o - p;
+struct DigitPairs {
+    char c[200];
+};
 
-    p++;
+static constexpr auto kDigitPairs = [] {
+    DigitPairs pairs{};
+    for (uint32_t i = 0; i < 100; i++) {
+        pairs.c[i * 2] = static_cast<char>('0' + i / 10);
+        pairs.c[i * 2 + 1] = static_cast<char>('0' + i % 10);
+    }
+    return pairs;
+}();
 
-    while (p < buffer + (sizeof(buffer) / sizeof(buffer[0]))) {
-        PutChar(ctx, static_cast<int>(*p++));
+/*
+ * Two digits per division, the digits are stored backwards from end.
+ * @return The first digit.
+ */
+static char* Utoa(uint32_t arg, char* end) {
+    while (arg >= 100) {
+        const auto* pair = &kDigitPairs.c[(arg % 100) * 2];
+        arg /= 100;
+        *--end = pair[1];
+        *--end = pair[0];
     }
 
-    while (i++ < ctx->width) {
-        PutChar(ctx, static_cast<int>(' '));
+    if (arg >= 10) {
+        const auto* pair = &kDigitPairs.c[arg * 2];
+        *--end = pair[1];
+        *--end = pair[0];
+    } else {
+        *--end = static_cast<char>('0' + arg);
     }
+
+    return end;
 }
 
-static void FormatInt(struct Context* ctx, uint32_t arg) {
-    char buffer[64];
-    char* p = buffer + (sizeof(buffer) / sizeof(buffer[0])) - 1;
-    char* o = p;
-    int i;
+static char* Xtoa(uint32_t arg, char* end, bool is_uppercase) {
+    const auto* digits = is_uppercase ? "0123456789ABCDEF" : "0123456789abcdef";
 
-    if (arg == 0) {
-        *p = '0';
-        p--;
-    } else {
-        do {
-            *p = static_cast<char>((arg % 10) + '0');
-            p--;
-            arg = arg / 10;
-        } while ((arg != 0) && (p > buffer));
+    do {
+        *--end = digits[arg & 0x0F];
+        arg = arg >> 4;
+    } while (arg != 0);
+
+    return end;
+}
+
+static constexpr int kNumberSize = 24; ///< Digits, zeros and sign of the common widths
+
+/*
+ * Precision and zero padding, then the sign, then the width.
+ * The zeros and the sign are stored in front of the digits when they fit.
+ */
+static void FormatNumber(struct Context* ctx, char* buffer, char* digits, int length) {
+    const auto kSign = ((ctx->flag & kFlagNegative) != 0) ? 1 : 0;
+
+    if (__builtin_expect(((ctx->width == 0) && ((ctx->flag & kFlagPrecision) == 0)), 1)) {
+        if (kSign != 0) {
+            *--digits = '-';
+            length++;
+        }
+        Write(ctx, digits, length);
+        return;
     }
 
+    auto zeros = 0;
+
     if ((ctx->flag & kFlagPrecision) != 0) {
-        while (((o - p) < ctx->prec) && (p > buffer)) {
-            *p-- = '0';
-        }
+        zeros = ctx->prec - length;
     }
 
-    if ((ctx->flag & kFlagZeroPadded) != 0) {
-        while (((o - p) < ctx->width) && (p > buffer)) {
-            *p-- = '0';
-        }
+    if (((ctx->flag & kFlagZeroPadded) != 0) && ((ctx->width - kSign - length) > zeros)) {
+        zeros = ctx->width - kSign - length;
     }
 
-    if ((ctx->flag & kFlagNegative) != 0) {
-        *p-- = '-';
+    if (zeros < 0) {
+        zeros = 0;
     }
 
+    const auto kSize = kSign + zeros + length;
+
     if ((ctx->flag & kFlagLeftJustified) == 0) {
-        while (((o - p) < ctx->width) && (p > buffer)) {
-            *p-- = ' ';
+        Pad(ctx, ' ', ctx->width - kSize);
+    }
+
+    if ((zeros + kSign) <= (digits - buffer)) {
+        while (zeros-- > 0) {
+            *--digits = '0';
+        }
+        if (kSign != 0) {
+            *--digits = '-';
         }
+        Write(ctx, digits, kSize);
+    } else {
+        if (kSign != 0) {
+            PutChar(ctx, '-');
+        }
+        Pad(ctx, '0', zeros);
+        Write(ctx, digits, length);
     }
 
-    i = o - p;
+    if ((ctx->flag & kFlagLeftJustified) != 0) {
+        Pad(ctx, ' ', ctx->width - kSize);
+    }
+}
 
-    p++;
+static void FormatHex(struct Context* ctx, uint32_t arg) {
+    char buffer[kNumberSize];
+    auto* end = buffer + sizeof(buffer);
+    auto* p = Xtoa(arg, end, (ctx->flag & kFlagUppercase) != 0);
 
-    while (p < buffer + (sizeof(buffer) / sizeof(buffer[0]))) {
-        PutChar(ctx, static_cast<int>(*p++));
-    }
+    FormatNumber(ctx, buffer, p, static_cast<int>(end - p));
+}
 
-    while (i++ < ctx->width) {
-        PutChar(ctx, static_cast<int>(' '));
-    }
+static void FormatInt(struct Context* ctx, uint32_t arg) {
+    char buffer[kNumberSize];
+    auto* end = buffer + sizeof(buffer);
+    auto* p = Utoa(arg, end);
+
+    FormatNumber(ctx, buffer, p, static_cast<int>(end - p));
 }
 
 #if !defined(DISABLE_PRINTF_FLOAT)
@@ -190,47 +303,29 @@ static int Pow10(int n) {
 }
 
 static int Itostr(int x, char* s, int d) {
-    char buffer[64];
-    auto* p = buffer + (sizeof(buffer) / sizeof(buffer[0])) - 1;
-    auto* o = p;
+    char buffer[24];
+    auto* end = buffer + sizeof(buffer);
     auto* t = s;
 
     const auto kIsNeg = x < 0 ? true : false;
 
-    if (kIsNeg) {
-        x = -x;
-    }
-
-    if (x == 0) {
-        *p = '0';
-        p--;
-    } else {
-        do {
-            *p = static_cast<char>((x % 10) + '0');
-            p--;
-            x = x / 10;
-        } while ((x != 0) && (p > buffer));
-    }
+    auto* p = Utoa(kIsNeg ? 0U - static_cast<uint32_t>(x) : static_cast<uint32_t>(x), end);
 
-    if (d != 0) {
-        while (((o - p) < d) && (p > buffer)) {
-            *p-- = '0';
-        }
+    while ((end - p) < d) {
+        *--p = '0';
     }
 
     if (kIsNeg) {
-        *p-- = '-';
+        *--p = '-';
     }
 
-    p++;
+    const auto kLength = static_cast<int>(end - p);
 
-    auto i = (o - p);
-
-    while (p < buffer + (sizeof(buffer) / sizeof(buffer[0]))) {
+    while (p < end) {
         *t++ = *p++;
     }
 
-    return i + 1;
+    return kLength;
 }
 
 static constexpr int kMaxPrecision = 6;
@@ -243,8 +338,6 @@ static void FormatFloat(struct Context* ctx, float f) {
     auto* dest = buffer;
     int ipart;
     int precision;
-    int size;
-    int i;
 
     if (((ctx->flag & kFlagPrecision) != 0) && (ctx->prec <= kMaxPrecision)) {
         precision = ctx->prec;
@@ -269,43 +362,35 @@ static void FormatFloat(struct Context* ctx, float f) {
 
     *dest++ = '.';
     dest += Itostr(static_cast<int>(f * static_cast<float>(Pow10(precision))), dest, precision);
-    size = dest - buffer;
 
-    i = 0;
-    while (((size + i) < ctx->width)) {
-        PutChar(ctx, static_cast<int>(' '));
-        i++;
-    }
+    const auto kSize = static_cast<int>(dest - buffer);
 
-    dest = buffer;
-    while (size-- > 0) {
-        PutChar(ctx, static_cast<int>(*dest++));
-    }
+    Pad(ctx, ' ', ctx->width - kSize);
+    Write(ctx, buffer, kSize);
 }
 #endif
 
 static void FormatString(struct Context* ctx, const char* s) {
-    int j;
+    if (s == nullptr) {
+        s = "(null)";
+    }
 
-    for (j = 0; s[j] != 0; j++); // strlen
+    int length;
 
     if ((ctx->flag & kFlagPrecision) != 0) {
-        if (ctx->prec < j) {
-            j = ctx->prec;
-        }
+        length = static_cast<int>(strnlen(s, static_cast<size_t>(ctx->prec)));
+    } else {
+        length = static_cast<int>(strlen(s));
     }
 
-    while ((((ctx->flag & kFlagLeftJustified) == 0)) && (j++ < ctx->width)) {
-        PutChar(ctx, ' ');
+    if ((ctx->flag & kFlagLeftJustified) == 0) {
+        Pad(ctx, ' ', ctx->width - length);
     }
 
-    while ((((ctx->flag & kFlagPrecision) == 0) || (ctx->prec != 0)) && (*s != 0)) {
-        PutChar(ctx, *s++);
-        ctx->prec--;
-    }
+    Write(ctx, s, length);
 
-    while (j++ < ctx->width) {
-        PutChar(ctx, ' ');
+    if ((ctx->flag & kFlagLeftJustified) != 0) {
+        Pad(ctx, ' ', ctx->width - length);
     }
 }
 
@@ -313,123 +398,159 @@ static void FormatPointer(struct Context* ctx, unsigned int arg) {
     ctx->width = 8;
     ctx->flag = kFlagZeroPadded;
 
-    PutChar(ctx, static_cast<int>('0'));
-    PutChar(ctx, static_cast<int>('x'));
+    Write(ctx, "0x", 2);
 
     FormatHex(ctx, arg);
 }
 
-static int Vprintf(int size, const char* fmt, va_list va) {
-    struct Context ctx;
-#if !defined(DISABLE_PRINTF_FLOAT)
-    float f;
-#endif
+static int Vprintf(struct Context* ctx, const char* fmt, va_list va) {
     int32_t l;
     uint32_t lu;
-    const char* s;
 
-    ctx.total = 0;
-    ctx.capacity = size;
+    ctx->total = 0;
 
     while (*fmt != 0) {
         if (*fmt != '%') {
-            PutChar(&ctx, static_cast<int>(*fmt++));
+            const auto* text = fmt;
+
+            do {
+                fmt++;
+            } while ((*fmt != '%') && (*fmt != '\0'));
+
+            Write(ctx, text, static_cast<int>(fmt - text));
             continue;
         }
 
         fmt++;
 
-        ctx.flag = 0;
-        ctx.prec = 0;
-        ctx.width = 0;
+        ctx->flag = 0;
+        ctx->prec = 0;
+        ctx->width = 0;
 
         if (*fmt == '0') {
-            ctx.flag |= kFlagZeroPadded;
+            ctx->flag |= kFlagZeroPadded;
             fmt++;
         } else if (*fmt == '-') {
-            ctx.flag |= kFlagLeftJustified;
+            ctx->flag |= kFlagLeftJustified;
             fmt++;
         }
 
-        while (isdigit(static_cast<int>(*fmt)) != 0) {
-            ctx.width = ctx.width * 10 + (*fmt - '0');
+        while ((*fmt >= '0') && (*fmt <= '9')) {
+            ctx->width = ctx->width * 10 + (*fmt - '0');
             fmt++;
         }
 
-        if (ctx.width != 0) {
-            ctx.flag |= kFlagMinWidth;
+        if (ctx->width != 0) {
+            ctx->flag |= kFlagMinWidth;
         }
 
         if (*fmt == '.') {
             fmt++;
             if (*fmt == '*') {
                 fmt++;
-                ctx.prec = va_arg(va, int);
-                if (ctx.prec < 0) {
-                    ctx.prec = -ctx.prec;
+                ctx->prec = va_arg(va, int);
+                if (ctx->prec < 0) {
+                    ctx->prec = -ctx->prec;
                 }
             } else {
-                while (isdigit(static_cast<int>(*fmt)) != 0) {
-                    ctx.prec = ctx.prec * 10 + (*fmt - '0');
+                while ((*fmt >= '0') && (*fmt <= '9')) {
+                    ctx->prec = ctx->prec * 10 + (*fmt - '0');
                     fmt++;
                 }
             }
-            ctx.flag |= kFlagPrecision;
+            ctx->flag |= kFlagPrecision;
         }
 
         if (*fmt == 'l') {
             fmt++;
-            ctx.flag |= kFlagLong;
+            ctx->flag |= kFlagLong;
         }
 
         switch (*fmt) {
             case 'c':
-                PutChar(&ctx, va_arg(va, int));
+                PutChar(ctx, static_cast<char>(va_arg(va, int)));
                 break;
             case 'd':
                 /*@fallthrough@*/
                 /* no break */
             case 'i':
-                l = ((ctx.flag & kFlagLong) != 0) ? va_arg(va, long int) : static_cast<int32_t>(va_arg(va, int));
+                l = ((ctx->flag & kFlagLong) != 0) ? static_cast<int32_t>(va_arg(va, long int)) : static_cast<int32_t>(va_arg(va, int));
                 if (l < 0) {
-                    ctx.flag |= kFlagNegative;
-                    l = -l;
+                    ctx->flag |= kFlagNegative;
+                    lu = 0U - static_cast<uint32_t>(l);
+                } else {
+                    lu = static_cast<uint32_t>(l);
                 }
-                FormatInt(&ctx, static_cast<uint32_t>(l));
+                FormatInt(ctx, lu);
                 break;
 #if !defined(DISABLE_PRINTF_FLOAT)
             case 'f':
-                f = static_cast<float>(va_arg(va, double));
-                FormatFloat(&ctx, f);
+                FormatFloat(ctx, static_cast<float>(va_arg(va, double)));
                 break;
 #endif
             case 'p':
-                FormatPointer(&ctx, va_arg(va, unsigned int));
+                FormatPointer(ctx, va_arg(va, unsigned int));
                 break;
             case 's':
-                s = va_arg(va, const char*);
-                FormatString(&ctx, s);
+                FormatString(ctx, va_arg(va, const char*));
                 break;
             case 'u':
-                lu = ((ctx.flag & kFlagLong) != 0) ? va_arg(va, unsigned long int) : va_arg(va, unsigned int);
-                FormatInt(&ctx, lu);
+                lu = ((ctx->flag & kFlagLong) != 0) ? static_cast<uint32_t>(va_arg(va, unsigned long int)) : va_arg(va, unsigned int);
+                FormatInt(ctx, lu);
                 break;
             case 'X':
-                ctx.flag |= kFlagUppercase;
+                ctx->flag |= kFlagUppercase;
                 /*@fallthrough@*/
                 /* no break */
             case 'x':
-                FormatHex(&ctx, va_arg(va, unsigned int));
+                FormatHex(ctx, va_arg(va, unsigned int));
+                break;
+            case '%':
+                PutChar(ctx, '%');
                 break;
+            case '\0':
+                return ctx->total;
             default:
-                PutChar(&ctx, static_cast<int>(*fmt));
+                // Not a conversion, the character is printed and examined again
+                PutChar(ctx, *fmt);
                 continue;
         }
 
         fmt++;
     }
 
-    return ctx.total;
+    return ctx->total;
+}
+
+static int ConsoleVprintf(const char* fmt, va_list va) {
+    char chunk[kChunkSize];
+    struct Context ctx;
+
+    ctx.out = chunk;
+    ctx.chunk = chunk;
+    ctx.available = kChunkSize;
+
+    const auto kTotal = Vprintf(&ctx, fmt, va);
+
+    Flush(&ctx);
+
+    return kTotal;
+}
+
+static int BufferVprintf(char* str, size_t size, const char* fmt, va_list va) {
+    struct Context ctx;
+
+    ctx.out = str;
+    ctx.chunk = nullptr;
+    ctx.available = (size == 0) ? 0 : static_cast<uint32_t>(size - 1);
+
+    const auto kTotal = Vprintf(&ctx, fmt, va);
+
+    if (size != 0) {
+        *ctx.out = '\0';
+    }
+
+    return kTotal;
 }
 
 extern "C" {
@@ -438,7 +559,11 @@ int printf(const char* fmt, ...) // NOLINT
     va_list arp;
     va_start(arp, fmt);
 
-    auto i = Vprintf(INT_MAX, fmt, arp);
+#if defined(CONFIG_CLIB_USE_UART0) && defined(CONFIG_USART0_TX_DEFERRED)
+    auto i = uart0::Deferred(fmt, arp);
+#else
+    auto i = ConsoleVprintf(fmt, arp);
+#endif
 
     va_end(arp);
 
@@ -447,7 +572,11 @@ int printf(const char* fmt, ...) // NOLINT
 
 int vprintf(const char* fmt, va_list arp) // NOLINT
 {
-    auto i = Vprintf(INT_MAX, fmt, arp);
+#if defined(CONFIG_CLIB_USE_UART0) && defined(CONFIG_USART0_TX_DEFERRED)
+    auto i = uart0::Deferred(fmt, arp);
+#else
+    auto i = ConsoleVprintf(fmt, arp);
+#endif
 
     return i;
 }
@@ -455,54 +584,30 @@ int vprintf(const char* fmt, va_list arp) // NOLINT
 int sprintf(char* str, const char* fmt, ...) // NOLINT
 {
     va_list arp;
-
-    outptr = str;
     va_start(arp, fmt);
 
-    auto i = Vprintf(INT_MAX, fmt, arp);
+    auto i = BufferVprintf(str, INT_MAX, fmt, arp);
 
     va_end(arp);
 
-    *outptr = 0;
-    outptr = nullptr;
-
     return i;
 }
 
 int vsprintf(char* str, const char* fmt, va_list ap) // NOLINT
 {
-    outptr = str;
-
-    auto i = Vprintf(INT_MAX, fmt, ap);
-
-    *outptr = 0;
-    outptr = nullptr;
-
-    return i;
+    return BufferVprintf(str, INT_MAX, fmt, ap);
 }
 
 int vsnprintf(char* str, size_t size, const char* fmt, va_list ap) // NOLINT
 {
-    if (size == 0) {
-        outptr = nullptr;           // don't write anywhere
-        return Vprintf(0, fmt, ap); // just count
-    }
-
-    outptr = str;
-
-    auto i = Vprintf((int)size, fmt, ap);
-
-    *outptr = 0;
-    outptr = nullptr;
-
-    return i;
+    return BufferVprintf(str, size, fmt, ap);
 }
 
 int snprintf(char* str, size_t size, const char* fmt, ...) // NOLINT
 {
     va_list ap;
     va_start(ap, fmt);
-    int i = vsnprintf(str, size, fmt, ap);
+    int i = BufferVprintf(str, size, fmt, ap);
     va_end(ap);
     return i;
 }
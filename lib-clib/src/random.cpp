@@ -32,9 +32,10 @@ static long int bit;
 
 extern "C" void srandom(unsigned int seed) // NOLINT
 {
-    if (seed != 0) {
-        lfsr = seed & 0xFFFFu;
-    } else {
+    // The LFSR has 16 bits of state, fold the upper half in. A zero state never changes.
+    lfsr = (seed ^ (seed >> 16)) & 0xFFFFu;
+
+    if (lfsr == 0) {
         lfsr = 0xACE1u;
     }
 }
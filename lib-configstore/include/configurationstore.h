@@ -105,7 +105,8 @@ struct Network {
     uint32_t name_server_ip;
     uint32_t ntp_server_ip;
     uint8_t host_name[network::kHostnameSize];
-    uint8_t reserved[8];
+    uint32_t dhcp_lease_ip; ///< Last address bound by DHCP, requested with INIT-REBOOT at startup
+    uint8_t reserved[4];
 } PACKED;
 
 static_assert(sizeof(Network) == kNetworkSize);
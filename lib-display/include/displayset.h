@@ -55,6 +55,8 @@ class DisplaySet
     virtual void PutChar(int) = 0;
     virtual void PutString(const char*) = 0;
 
+    virtual void Text(const char* data, uint32_t length) = 0;
+
     virtual void TextLine(uint32_t line, const char* data, uint32_t length) = 0;
 
     virtual void SetCursorPos(uint32_t col, uint32_t row) = 0;
@@ -48,6 +48,9 @@
 #include <cassert>
 
 #include "displayset.h"
+#if defined(CONFIG_DISPLAY_FRAMEBUFFER)
+#include "i2c/framebuffer.h"
+#endif
 #include "ansi_colour.h"
 #if defined(DISPLAYTIMEOUT_GPIO)
 #include "gpio.h"
@@ -290,7 +293,21 @@ class Display {
 
     uint32_t GetSleepTimeout() const { return sleep_timeout_ / 1000U / 60U; }
 
+    void Flush() {
+#if defined(CONFIG_DISPLAY_FRAMEBUFFER)
+        if (framebuffer_ != nullptr) {
+            framebuffer_->Flush();
+        }
+#endif
+    }
+
     void Run() {
+#if defined(CONFIG_DISPLAY_FRAMEBUFFER)
+        if (framebuffer_ != nullptr) {
+            framebuffer_->Run();
+        }
+#endif
+
         if (sleep_timeout_ == 0) {
             return;
         }
@@ -312,6 +329,7 @@ class Display {
    private:
     void Detect(display::Type display_type);
     void Detect(uint32_t rows);
+    void AttachFrameBuffer();
     void SetSleepTimer(bool active);
 
    private:
@@ -323,6 +341,9 @@ class Display {
     bool is_flipped_vertically_{false};
 
     DisplaySet* lcd_display_{nullptr};
+#if defined(CONFIG_DISPLAY_FRAMEBUFFER)
+    DisplayFrameBuffer* framebuffer_{nullptr};
+#endif
     static inline Display* s_this;
 };
 
@@ -0,0 +1,99 @@
+/**
+ * @file framebuffer.h
+ *
+ */
+/* Copyright (C) 2026 by Arjan van Vught mailto:info@gd32-dmx.org
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef I2C_FRAMEBUFFER_H_
+#define I2C_FRAMEBUFFER_H_
+
+#include <cstdint>
+
+#include "displayset.h"
+
+namespace display::framebuffer {
+inline constexpr uint32_t kColumnsMax = 24;
+inline constexpr uint32_t kRowsMax = 8;
+static_assert(kColumnsMax <= 32, "A row has a 32-bit dirty mask");
+#if defined(CONFIG_DISPLAY_FLUSH_MILLIS)
+inline constexpr uint32_t kFlushMillis = CONFIG_DISPLAY_FLUSH_MILLIS;
+#else
+inline constexpr uint32_t kFlushMillis = 100; ///< 10 frames per second
+#endif
+} // namespace display::framebuffer
+
+/*
+ * Character framebuffer in front of a DisplaySet (CONFIG_DISPLAY_FRAMEBUFFER).
+ * The text calls only update the cells, a cell which changes is marked dirty.
+ * Run() starts a flush at most every kFlushMillis and sends the dirty cells of
+ * one row per call, so the bus time per superloop iteration is bounded.
+ * The cells start unknown ('\0'), what is on the panel is kept until written.
+ */
+class DisplayFrameBuffer final : public DisplaySet {
+   public:
+    explicit DisplayFrameBuffer(DisplaySet* display);
+    ~DisplayFrameBuffer() override { delete display_; }
+
+    bool Start() override { return true; }
+
+    void Cls() override;
+    void ClearLine(uint32_t line) override;
+
+    void PutChar(int c) override;
+    void PutString(const char* string) override;
+
+    void Text(const char* data, uint32_t length) override;
+
+    void TextLine(uint32_t line, const char* data, uint32_t length) override;
+
+    void SetCursorPos(uint32_t column, uint32_t row) override;
+    void SetCursor(uint32_t mode) override;
+
+    void SetSleep(bool sleep) override { display_->SetSleep(sleep); }
+    void SetContrast(uint8_t contrast) override { display_->SetContrast(contrast); }
+    void SetFlipVertically(bool do_flip_vertically) override { display_->SetFlipVertically(do_flip_vertically); }
+
+    void PrintInfo() override { display_->PrintInfo(); }
+
+    void Run();
+    void Flush();
+
+    [[nodiscard]] bool IsDirty() const;
+
+   private:
+    void Set(uint32_t column, uint32_t row, char c);
+    void Fill(uint32_t column, uint32_t row);
+    bool FlushRow();
+
+   private:
+    DisplaySet* display_;
+    uint32_t column_{0};
+    uint32_t row_{0};
+    uint32_t cursor_mode_{display::cursor::kOff};
+    uint32_t flush_row_{0};
+    uint32_t flush_millis_{0};
+    bool is_flushing_{false};
+    char cells_[display::framebuffer::kRowsMax][display::framebuffer::kColumnsMax];
+    uint32_t dirty_[display::framebuffer::kRowsMax]; ///< Bit per column
+};
+
+#endif // I2C_FRAMEBUFFER_H_
@@ -44,12 +44,7 @@ class Ssd1306 final : public DisplaySet {
     Ssd1306();
     explicit Ssd1306(OledPanel);
     Ssd1306(uint8_t, OledPanel);
-    ~Ssd1306() override {
-#if defined(CONFIG_DISPLAY_ENABLE_CURSOR_MODE)
-        delete[] shadow_ram_;
-        shadow_ram_ = nullptr;
-#endif
-    }
+    ~Ssd1306() override = default;
 
     bool Start() override;
 
@@ -59,7 +54,7 @@ class Ssd1306 final : public DisplaySet {
     void PutChar(int) override;
     void PutString(const char*) override;
 
-    void Text(const char* data, uint32_t length);
+    void Text(const char* data, uint32_t length) override;
     void TextLine(uint32_t line, const char* data, uint32_t length) override;
 
     void SetCursorPos(uint32_t column, uint32_t row) override;
@@ -87,17 +82,26 @@ class Ssd1306 final : public DisplaySet {
     void SetCursorBlinkOn();
     void SetColumnRow(uint8_t column, uint8_t row);
 
+    void SetAddress(uint32_t column, uint32_t page);
+    void WriteText(const char* data, uint32_t length);
+    void WriteCells(const char* data, uint32_t length);
+    void SendLine(uint32_t row, uint32_t first, uint32_t end);
+
     void DumpShadowRam();
 
    private:
+    static constexpr uint32_t kCharW = 6;
+    static constexpr uint32_t kColumns = 128 / kCharW;
+    static constexpr uint32_t kRowsMax = 8;
+    static constexpr uint32_t kLineSize = 1 + kColumns * kCharW; ///< Control byte and the glyph columns
+
     I2c i2c_;
     OledPanel oled_panel_{OledPanel::k128x648Rows};
     bool have_sh1106_{false};
     uint32_t pages_;
-#if defined(CONFIG_DISPLAY_ENABLE_CURSOR_MODE) || defined(CONFIG_DISPLAY_FIX_FLIP_VERTICALLY)
-    char* shadow_ram_{nullptr};
     uint32_t shadow_ram_index_{0};
-#endif
+    char shadow_ram_[kRowsMax * kColumns];   ///< The characters on the panel
+    uint8_t page_ram_[kRowsMax][kLineSize]; ///< The GDDRAM of the text lines, in page layout
 #if defined(CONFIG_DISPLAY_ENABLE_CURSOR_MODE)
     uint32_t cursor_mode_{display::cursor::kOff};
     uint8_t cursor_on_char_;
@@ -45,6 +45,10 @@
 #include <cstdarg>
 #include <cstdint>
 #include <cstdio>
+#if defined(CONFIG_DISPLAY_FRAMEBUFFER)
+#include <cstring>
+#include <cassert>
+#endif
 
 #if defined(CONFIG_USE_ILI9341)
 #include "spi/ili9341.h"
@@ -62,6 +66,9 @@ using LcdDriver = ST7789;
 #if defined(DISPLAYTIMEOUT_GPIO)
 #include "gpio.h"
 #endif
+#if defined(CONFIG_DISPLAY_FRAMEBUFFER)
+#include "timing.h"
+#endif
 #include "display_debug.h"
 
 #if defined(SPI_LCD_HAVE_CS_GPIO)
@@ -78,11 +85,15 @@ class Display : public LcdDriver {
         s_this = this;
 
         SetBackLight(1);
-        SetFlipVertically(false);
+        LcdDriver::SetRotation(1);
         FillColour(kColorBackground);
 
         cols_ = (GetWidth() / s_pFONT->kWidth);
         rows_ = (GetHeight() / s_pFONT->kHeight);
+#if defined(CONFIG_DISPLAY_FRAMEBUFFER)
+        assert((s_pFONT->kWidth == kFontWidth) && (s_pFONT->kHeight == kFontHeight));
+        ClearCells();
+#endif
 #if defined(DISPLAYTIMEOUT_GPIO)
         gpio::Fsel(DISPLAYTIMEOUT_GPIO, gpio::Select::kInput);
         gpio::SetPud(DISPLAYTIMEOUT_GPIO, gpio::Pull::kUp);
@@ -107,7 +118,12 @@ class Display : public LcdDriver {
         printf("(%u,%u)\n", static_cast<unsigned>(rows_), static_cast<unsigned>(cols_));
     }
 
-    void Cls() { FillColour(kColorBackground); }
+    void Cls() {
+        FillColour(kColorBackground);
+#if defined(CONFIG_DISPLAY_FRAMEBUFFER)
+        ClearCells();
+#endif
+    }
 
     void SetCursorPos(uint32_t nCol, uint32_t row) {
         cursor_x_ = nCol * s_pFONT->kWidth;
@@ -115,7 +131,11 @@ class Display : public LcdDriver {
     }
 
     void PutChar(int c) {
+#if defined(CONFIG_DISPLAY_FRAMEBUFFER)
+        Set(cursor_x_ / s_pFONT->kWidth, cursor_y_ / s_pFONT->kHeight, static_cast<char>(c));
+#else
         DrawChar(cursor_x_, cursor_y_, static_cast<char>(c), s_pFONT, kColorBackground, kColorForeground);
+#endif
 
         cursor_x_ += s_pFONT->kWidth;
 
@@ -252,6 +272,17 @@ class Display : public LcdDriver {
 
     uint32_t GetSleepTimeout() const { return sleep_timeout_ / 1000U / 60U; }
 
+    void SetRotation(uint32_t rotation) {
+        LcdDriver::SetRotation(rotation);
+
+        cols_ = (GetWidth() / s_pFONT->kWidth);
+        rows_ = (GetHeight() / s_pFONT->kHeight);
+#if defined(CONFIG_DISPLAY_FRAMEBUFFER)
+        FillColour(kColorBackground);
+        SetAllDirty();
+#endif
+    }
+
     void SetFlipVertically(bool doFlipVertically) { SetRotation(doFlipVertically ? 3 : 1); }
 
     uint32_t GetColumns() const { return cols_; }
@@ -262,7 +293,24 @@ class Display : public LcdDriver {
 
     bool GetFlipVertically() const { return is_flipped_vertically_; }
 
+    // Draws all the dirty cells now, for code which does not return to the superloop
+    void Flush() {
+#if defined(CONFIG_DISPLAY_FRAMEBUFFER)
+        flush_row_ = 0;
+
+        while (FlushRow()) {
+        }
+
+        is_flushing_ = false;
+        flush_millis_ = timing::Millis();
+#endif
+    }
+
     void Run() {
+#if defined(CONFIG_DISPLAY_FRAMEBUFFER)
+        FlushStep();
+#endif
+
         if (sleep_timeout_ == 0) {
             return;
         }
@@ -281,6 +329,111 @@ class Display : public LcdDriver {
    private:
     void SetSleepTimer(const bool bActive);
 
+#if defined(CONFIG_DISPLAY_FRAMEBUFFER)
+    /*
+     * The text calls only update the cells, a cell which changes is marked dirty.
+     * Run() starts a flush at most every kFlushMillis and draws the dirty runs of
+     * one text line per call with Paint::DrawText.
+     */
+    void ClearCells() {
+        memset(cells_, ' ', sizeof(cells_));
+        memset(dirty_, 0, sizeof(dirty_));
+        is_flushing_ = false;
+    }
+
+    void Set(uint32_t column, uint32_t row, char c) {
+        if (__builtin_expect(((column >= cols_) || (row >= rows_)), 0)) {
+            return;
+        }
+
+        if (cells_[row][column] != c) {
+            cells_[row][column] = c;
+            dirty_[row][column / 32U] |= (1U << (column % 32U));
+        }
+    }
+
+    // After a rotation all the cells in the new geometry are drawn again
+    void SetAllDirty() {
+        memset(dirty_, 0, sizeof(dirty_));
+
+        for (uint32_t row = 0; row < rows_; row++) {
+            for (uint32_t column = 0; column < cols_; column++) {
+                dirty_[row][column / 32U] |= (1U << (column % 32U));
+            }
+        }
+
+        is_flushing_ = false;
+    }
+
+    bool IsDirty() const {
+        for (uint32_t row = 0; row < rows_; row++) {
+            for (const auto kMask : dirty_[row]) {
+                if (kMask != 0) {
+                    return true;
+                }
+            }
+        }
+
+        return false;
+    }
+
+    bool FlushRow() {
+        for (; flush_row_ < rows_; flush_row_++) {
+            auto is_dirty = false;
+
+            for (uint32_t word = 0; word < kDirtyWords; word++) {
+                auto mask = dirty_[flush_row_][word];
+
+                if (mask == 0) {
+                    continue;
+                }
+
+                dirty_[flush_row_][word] = 0;
+                is_dirty = true;
+
+                while (mask != 0) {
+                    const auto kFirst = static_cast<uint32_t>(__builtin_ctz(mask));
+                    const auto kRun = static_cast<uint32_t>(__builtin_ctzll(~(static_cast<uint64_t>(mask) >> kFirst)));
+                    const auto kColumn = word * 32U + kFirst;
+
+                    DrawText(kColumn * s_pFONT->kWidth, flush_row_ * s_pFONT->kHeight, &cells_[flush_row_][kColumn], kRun, s_pFONT, kColorBackground, kColorForeground);
+
+                    mask &= ~static_cast<uint32_t>(((uint64_t{1} << kRun) - 1U) << kFirst);
+                }
+            }
+
+            if (is_dirty) {
+                flush_row_++;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void FlushStep() {
+        if (!is_flushing_) {
+            if (!IsDirty()) {
+                return;
+            }
+
+            const auto kMillis = timing::Millis();
+
+            if ((kMillis - flush_millis_) < kFlushMillis) {
+                return;
+            }
+
+            flush_millis_ = kMillis;
+            flush_row_ = 0;
+            is_flushing_ = true;
+        }
+
+        if (!FlushRow()) {
+            is_flushing_ = false;
+        }
+    }
+#endif
+
     uint32_t cols_;
     uint32_t rows_;
     uint32_t sleep_timeout_{1000U * 60U * display::Defaults::kSleepTimeout};
@@ -306,6 +459,35 @@ class Display : public LcdDriver {
 #endif
     static constexpr uint16_t kColorBackground = 0x001F;
     static constexpr uint16_t kColorForeground = 0xFFE0;
+
+#if defined(CONFIG_DISPLAY_FRAMEBUFFER)
+    // The fonts are extern, their size is repeated here for the cell arrays
+#if defined(SPI_LCD_240X320)
+    static constexpr uint32_t kFontWidth = 16;
+    static constexpr uint32_t kFontHeight = 24;
+#elif defined(SPI_LCD_128X128) || defined(SPI_LCD_160X80)
+    static constexpr uint32_t kFontWidth = 8;
+    static constexpr uint32_t kFontHeight = 8;
+#else
+    static constexpr uint32_t kFontWidth = 12;
+    static constexpr uint32_t kFontHeight = 12;
+#endif
+    // Any rotation fits
+    static constexpr uint32_t kSideMax = (config::lcd::kWidth > config::lcd::kHeight) ? config::lcd::kWidth : config::lcd::kHeight;
+    static constexpr uint32_t kColumnsMax = kSideMax / kFontWidth;
+    static constexpr uint32_t kRowsMax = kSideMax / kFontHeight;
+    static constexpr uint32_t kDirtyWords = (kColumnsMax + 31U) / 32U;
+#if defined(CONFIG_DISPLAY_FLUSH_MILLIS)
+    static constexpr uint32_t kFlushMillis = CONFIG_DISPLAY_FLUSH_MILLIS;
+#else
+    static constexpr uint32_t kFlushMillis = 100; ///< 10 frames per second
+#endif
+    uint32_t flush_row_{0};
+    uint32_t flush_millis_{0};
+    bool is_flushing_{false};
+    char cells_[kRowsMax][kColumnsMax];
+    uint32_t dirty_[kRowsMax][kDirtyWords]; ///< Bit per column
+#endif
 };
 
 #if defined(__GNUC__) && !defined(__clang__)
@@ -29,6 +29,7 @@
 #include <cstdint>
 #include <cstdlib>
 #include <cassert>
+#include <algorithm>
 
 #include "spi/lcd_font.h"
 #include "spi/spilcd.h"
@@ -168,6 +169,56 @@ class Paint : public SpiLcd {
         WriteData(reinterpret_cast<uint8_t*>(s_frame_buffer), index * 2);
     }
 
+    /*
+     * A run of characters on a text line, sent with a single address window.
+     * The pixel rows are rendered into one half of s_frame_buffer while the
+     * previous half is still being sent (StreamWrite).
+     */
+    void DrawText(uint32_t x0, uint32_t y0, const char* text, uint32_t count, sFONT* font, uint16_t colour_background, uint16_t colour_fore_ground) {
+        static constexpr uint32_t kHalfSize = sizeof(s_frame_buffer) / sizeof(s_frame_buffer[0]) / 2;
+        const uint32_t kCountMax = kHalfSize / font->kWidth;
+
+        while (count > kCountMax) {
+            DrawText(x0, y0, text, kCountMax, font, colour_background, colour_fore_ground);
+            x0 += kCountMax * font->kWidth;
+            text += kCountMax;
+            count -= kCountMax;
+        }
+
+        if (count == 0) {
+            return;
+        }
+
+        const auto kPixels = count * font->kWidth;
+        const auto kPagesMax = kHalfSize / kPixels;
+
+        SetAddressWindow(x0, y0, x0 + kPixels - 1, y0 + font->kHeight - 1U);
+
+        colour_fore_ground = __builtin_bswap16(colour_fore_ground);
+        colour_background = __builtin_bswap16(colour_background);
+
+        StreamStart();
+
+        uint32_t half = 0;
+        uint32_t page = 0;
+
+        while (page < font->kHeight) {
+            auto* buffer = &s_frame_buffer[half * kHalfSize];
+            auto* p = buffer;
+            const auto kPageEnd = std::min(page + kPagesMax, static_cast<uint32_t>(font->kHeight));
+
+            for (; page < kPageEnd; page++) {
+                for (uint32_t i = 0; i < count; i++) {
+                    const auto kLine = font->table[static_cast<uint32_t>(text[i] - ' ') * font->kHeight + page];
+                    p = RenderLine(p, kLine, font->kWidth, colour_background, colour_fore_ground);
+                }
+            }
+
+            StreamWrite(reinterpret_cast<uint8_t*>(buffer), static_cast<uint32_t>(p - buffer) * 2);
+            half ^= 1;
+        }
+    }
+
     /**
      * Bresenham
      */
@@ -215,6 +266,27 @@ class Paint : public SpiLcd {
 
     void SetCursor(uint32_t x, uint32_t y) { SetAddressWindow(x, y, x, y); }
 
+    /*
+     * One pixel row of a glyph, the bit order depends on the font width (see DrawChar).
+     */
+    static uint16_t* RenderLine(uint16_t* p, uint32_t line, uint32_t width, uint16_t colour_background, uint16_t colour_fore_ground) {
+        if (width < 16) {
+            const uint32_t kMask = (width == 8) ? 0x80 : 0x8000;
+
+            for (uint32_t column = 0; column < width; column++) {
+                *p++ = ((line & kMask) != 0) ? colour_fore_ground : colour_background;
+                line = line << 1;
+            }
+        } else {
+            for (uint32_t column = 0; column < width; column++) {
+                *p++ = ((line & 0x1) != 0) ? colour_fore_ground : colour_background;
+                line = line >> 1;
+            }
+        }
+
+        return p;
+    }
+
     void FillFramebuffer(uint16_t colour) {
         colour = __builtin_bswap16(colour);
 
@@ -82,6 +82,7 @@ class SpiLcd {
     void ClearDC() { gpio::Clr(SPI_LCD_DC_GPIO); }
 
     void WriteCommand(uint8_t data) {
+        WaitIdle();
         ClearCS();
         ClearDC();
         spi::Writenb(reinterpret_cast<char*>(&data), 1);
@@ -89,6 +90,7 @@ class SpiLcd {
     }
 
     void WriteData(const uint8_t* data, uint32_t length) {
+        WaitIdle();
         ClearCS();
         SetDC();
         spi::Writenb(reinterpret_cast<const char*>(data), length);
@@ -104,6 +106,7 @@ class SpiLcd {
     }
 
     void WriteDataByte(uint8_t data) {
+        WaitIdle();
         ClearCS();
         SetDC();
         spi::Writenb(reinterpret_cast<char*>(&data), 1);
@@ -111,6 +114,7 @@ class SpiLcd {
     }
 
     void WriteDataWord(uint16_t data) {
+        WaitIdle();
         ClearCS();
         SetDC();
         spi::Write(data);
@@ -118,6 +122,7 @@ class SpiLcd {
     }
 
     void WriteDataStart(uint8_t* data, uint32_t length) {
+        WaitIdle();
         ClearCS();
         SetDC();
         spi::Writenb(reinterpret_cast<char*>(data), length);
@@ -130,8 +135,43 @@ class SpiLcd {
         SetCS();
     }
 
+    /*
+     * Pixel data streamed with the SPI TX DMA (CONFIG_SPI_ENABLE_TX_DMA).
+     * StreamWrite() returns as soon as the transfer is started, the buffer
+     * must not be touched until the next StreamWrite() or WaitIdle().
+     * The chip select is released by WaitIdle(), which every blocking write does first.
+     */
+    void StreamStart() {
+        WaitIdle();
+        ClearCS();
+        SetDC();
+        is_streaming_ = true;
+    }
+
+    void StreamWrite(const uint8_t* data, uint32_t length) {
+#if defined(CONFIG_SPI_ENABLE_TX_DMA)
+        while (spi::DmaTxIsActive()) {
+        }
+        spi::DmaTxStart(data, length);
+#else
+        spi::Writenb(reinterpret_cast<const char*>(data), length);
+#endif
+    }
+
+    void WaitIdle() {
+        if (is_streaming_) {
+#if defined(CONFIG_SPI_ENABLE_TX_DMA)
+            while (spi::DmaTxIsActive()) {
+            }
+#endif
+            SetCS();
+            is_streaming_ = false;
+        }
+    }
+
    private:
     uint32_t cs_;
+    bool is_streaming_{false};
 };
 
 #endif // SPI_SPILCD_H_
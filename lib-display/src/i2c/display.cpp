@@ -65,6 +65,7 @@ Display::Display() {
     }
 
     if (lcd_display_ != nullptr) {
+        AttachFrameBuffer();
         display::timeout::GpioInit();
     }
 
@@ -82,6 +83,7 @@ Display::Display(uint32_t rows) {
     Detect(rows);
 
     if (lcd_display_ != nullptr) {
+        AttachFrameBuffer();
         display::timeout::GpioInit();
     }
 
@@ -96,6 +98,7 @@ Display::Display(display::Type type) : type_(type) {
     Detect(type);
 
     if (lcd_display_ != nullptr) {
+        AttachFrameBuffer();
         display::timeout::GpioInit();
     }
 
@@ -202,6 +205,18 @@ void Display::Detect(uint32_t rows) {
     }
 }
 
+/*
+ * With CONFIG_DISPLAY_FRAMEBUFFER the detected display is only written from
+ * Run(), the text calls update the framebuffer.
+ */
+void Display::AttachFrameBuffer() {
+#if defined(CONFIG_DISPLAY_FRAMEBUFFER)
+    framebuffer_ = new DisplayFrameBuffer(lcd_display_);
+    assert(framebuffer_ != nullptr);
+    lcd_display_ = framebuffer_;
+#endif
+}
+
 #undef DISPLAY_DEBUG_ENTRY
 #undef DISPLAY_DEBUG_EXIT
 #undef DISPLAY_DEBUG_PRINTF
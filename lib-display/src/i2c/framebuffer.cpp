@@ -0,0 +1,258 @@
+/**
+ * @file framebuffer.cpp
+ *
+ */
+/* Copyright (C) 2026 by Arjan van Vught mailto:info@gd32-dmx.org
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#if defined(CONFIG_DISPLAY_FRAMEBUFFER)
+
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <cassert>
+
+#include "i2c/framebuffer.h"
+#include "displayset.h"
+#include "timing.h"
+#include "display_debug.h"
+
+DisplayFrameBuffer::DisplayFrameBuffer(DisplaySet* display) : display_(display) {
+    DISPLAY_DEBUG_ENTRY();
+    assert(display_ != nullptr);
+
+    cols_ = std::min(display_->GetColumns(), display::framebuffer::kColumnsMax);
+    rows_ = std::min(display_->GetRows(), display::framebuffer::kRowsMax);
+
+    memset(cells_, '\0', sizeof(cells_));
+    memset(dirty_, 0, sizeof(dirty_));
+
+    DISPLAY_DEBUG_PRINTF("cols_=%u, rows_=%u", cols_, rows_);
+    DISPLAY_DEBUG_EXIT();
+}
+
+void DisplayFrameBuffer::Set(uint32_t column, uint32_t row, char c) {
+    if (cells_[row][column] != c) {
+        cells_[row][column] = c;
+        dirty_[row] |= (1U << column);
+    }
+}
+
+void DisplayFrameBuffer::Fill(uint32_t column, uint32_t row) {
+    for (; column < cols_; column++) {
+        Set(column, row, ' ');
+    }
+}
+
+void DisplayFrameBuffer::Cls() {
+    for (uint32_t row = 0; row < rows_; row++) {
+        Fill(0, row);
+    }
+
+    column_ = 0;
+    row_ = 0;
+}
+
+/**
+ * line [1..4]
+ */
+void DisplayFrameBuffer::ClearLine(uint32_t line) {
+    if (__builtin_expect(((line == 0) || (line > rows_)), 0)) {
+        return;
+    }
+
+    Fill(0, line - 1);
+
+    column_ = 0;
+    row_ = line - 1;
+}
+
+void DisplayFrameBuffer::PutChar(int c) {
+    if (__builtin_expect((row_ >= rows_), 0)) {
+        return;
+    }
+
+    Set(column_, row_, static_cast<char>(c));
+
+    if (++column_ == cols_) {
+        column_ = 0;
+        if (++row_ == rows_) {
+            row_ = 0;
+        }
+    }
+}
+
+void DisplayFrameBuffer::PutString(const char* string) {
+    while (*string != '\0') {
+        DisplayFrameBuffer::PutChar(static_cast<int>(*string++));
+    }
+
+    if (clear_end_of_line_) {
+        clear_end_of_line_ = false;
+        if (column_ != 0) {
+            Fill(column_, row_);
+            column_ = 0;
+            row_ = (row_ + 1 == rows_) ? 0 : row_ + 1;
+        }
+    }
+}
+
+void DisplayFrameBuffer::Text(const char* data, uint32_t length) {
+    length = std::min(length, cols_);
+
+    for (uint32_t i = 0; i < length; i++) {
+        DisplayFrameBuffer::PutChar(static_cast<int>(data[i]));
+    }
+
+    if (clear_end_of_line_) {
+        clear_end_of_line_ = false;
+        if (column_ != 0) {
+            Fill(column_, row_);
+            column_ = 0;
+            row_ = (row_ + 1 == rows_) ? 0 : row_ + 1;
+        }
+    }
+}
+
+void DisplayFrameBuffer::TextLine(uint32_t line, const char* data, uint32_t length) {
+    if (__builtin_expect(((line == 0) || (line > rows_)), 0)) {
+        return;
+    }
+
+    column_ = 0;
+    row_ = line - 1;
+
+    length = std::min(length, cols_);
+
+    for (uint32_t i = 0; i < length; i++) {
+        Set(i, row_, data[i]);
+    }
+
+    if (clear_end_of_line_) {
+        clear_end_of_line_ = false;
+        Fill(length, row_);
+        length = cols_;
+    }
+
+    column_ = length;
+
+    if (column_ == cols_) {
+        column_ = 0;
+        row_ = (row_ + 1 == rows_) ? 0 : row_ + 1;
+    }
+}
+
+/**
+ * (0,0)
+ */
+void DisplayFrameBuffer::SetCursorPos(uint32_t column, uint32_t row) {
+    if (__builtin_expect((!((column < cols_) && (row < rows_))), 0)) {
+        return;
+    }
+
+    column_ = column;
+    row_ = row;
+}
+
+void DisplayFrameBuffer::SetCursor(uint32_t mode) {
+    cursor_mode_ = mode;
+    display_->SetCursorPos(column_, row_);
+    display_->SetCursor(mode);
+}
+
+bool DisplayFrameBuffer::IsDirty() const {
+    for (uint32_t row = 0; row < rows_; row++) {
+        if (dirty_[row] != 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*
+ * Sends the runs of dirty cells of the next dirty row.
+ * @return false when the pass over the rows is complete.
+ */
+bool DisplayFrameBuffer::FlushRow() {
+    for (; flush_row_ < rows_; flush_row_++) {
+        auto mask = dirty_[flush_row_];
+
+        if (mask == 0) {
+            continue;
+        }
+
+        dirty_[flush_row_] = 0;
+
+        while (mask != 0) {
+            const auto kFirst = static_cast<uint32_t>(__builtin_ctz(mask));
+            const auto kRun = static_cast<uint32_t>(__builtin_ctz(~(mask >> kFirst)));
+
+            display_->SetCursorPos(kFirst, flush_row_);
+            display_->Text(&cells_[flush_row_][kFirst], kRun);
+
+            mask &= ~(((1U << kRun) - 1U) << kFirst);
+        }
+
+        if (cursor_mode_ != display::cursor::kOff) {
+            display_->SetCursorPos(column_, row_);
+        }
+
+        flush_row_++;
+        return true;
+    }
+
+    return false;
+}
+
+void DisplayFrameBuffer::Run() {
+    if (!is_flushing_) {
+        if (!IsDirty()) {
+            return;
+        }
+
+        const auto kMillis = timing::Millis();
+
+        if ((kMillis - flush_millis_) < display::framebuffer::kFlushMillis) {
+            return;
+        }
+
+        flush_millis_ = kMillis;
+        flush_row_ = 0;
+        is_flushing_ = true;
+    }
+
+    if (!FlushRow()) {
+        is_flushing_ = false;
+    }
+}
+
+// Sends all the dirty cells now, for code which does not return to the superloop
+void DisplayFrameBuffer::Flush() {
+    flush_row_ = 0;
+
+    while (FlushRow()) {
+    }
+
+    is_flushing_ = false;
+    flush_millis_ = timing::Millis();
+}
+#endif
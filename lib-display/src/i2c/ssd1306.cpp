@@ -26,6 +26,7 @@
 #include <cstdint>
 #include <cstring>
 #include <cstdio>
+#include <algorithm>
 #include <cassert>
 
 #include "i2c/ssd1306.h"
@@ -69,7 +70,7 @@ static constexpr auto kCols = (kLcdWidth / kCharW);
 
 } // namespace ssd1306
 
-static const uint8_t kOledFont8x6[] __attribute__((aligned(4))) = {
+static constexpr uint8_t kOledFont8x6[] __attribute__((aligned(4))) = {
 	0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
 	0x40, 0x00, 0x00, 0x5F, 0x00, 0x00, 0x00,
 	0x40, 0x00, 0x07, 0x00, 0x07, 0x00, 0x00,
@@ -168,6 +169,32 @@ static const uint8_t kOledFont8x6[] __attribute__((aligned(4))) = {
 	0x40, 0x3C, 0x26, 0x23, 0x26, 0x3C, 0x00
 };
 
+namespace ssd1306::oled::font8x6 {
+static constexpr uint32_t kGlyphs = sizeof(kOledFont8x6) / (kCharW + 1);
+static_assert(kGlyphs == 96, "Characters 32..127");
+
+/*
+ * The glyphs without the control byte, a byte is a column of 8 pixels, which
+ * is the page layout of the GDDRAM. A text line is a copy of the glyph columns.
+ */
+struct Atlas {
+    uint8_t glyph[kGlyphs][kCharW];
+};
+
+static constexpr auto kAtlas = [] {
+    Atlas atlas{};
+    for (uint32_t c = 0; c < kGlyphs; c++) {
+        for (uint32_t column = 0; column < kCharW; column++) {
+            atlas.glyph[c][column] = kOledFont8x6[c * (kCharW + 1) + 1 + column];
+        }
+    }
+    return atlas;
+}();
+
+static constexpr char kSpaces[kCols + 1] = "                     ";
+static_assert(sizeof(kSpaces) == kCols + 1);
+} // namespace ssd1306::oled::font8x6
+
 static constexpr uint8_t kOled128x64Init[] __attribute__((aligned(4))) = {
 		ssd1306::cmd::kDisplayOff,
 		ssd1306::cmd::kSetDisplayclockdiv, 0x80, 	// The suggested value
@@ -334,49 +361,22 @@ void Ssd1306::Cls() {
         SendData(reinterpret_cast<const uint8_t*>(&s_clear_buffer), (column_add + ssd1306::kLcdWidth + 1));
     }
 
-    SendCommand(ssd1306::cmd::kSetLowcolumn | (column_add & 0XF));
-    SendCommand(static_cast<uint8_t>(ssd1306::cmd::kSetHighcolumn | (column_add)));
-    SendCommand(ssd1306::cmd::kSetStartpage);
-
-#if defined(CONFIG_DISPLAY_ENABLE_CURSOR_MODE) || defined(CONFIG_DISPLAY_FIX_FLIP_VERTICALLY)
     shadow_ram_index_ = 0;
-    memset(shadow_ram_, ' ', ssd1306::oled::font8x6::kCols * rows_);
-#endif
-}
-
-void Ssd1306::PutChar(int c) {
-    int i;
+    memset(shadow_ram_, ' ', sizeof(shadow_ram_));
 
-    if (c < 32 || c > 127) {
-#if defined(CONFIG_DISPLAY_ENABLE_CURSOR_MODE) || defined(CONFIG_DISPLAY_FIX_FLIP_VERTICALLY)
-        c = 32;
-#endif
-        i = 0;
-    } else {
-        i = c - 32;
+    for (auto& line : page_ram_) {
+        line[0] = ssd1306::mode::kData;
+        memset(&line[1], 0, kLineSize - 1);
     }
+}
 
-#if defined(CONFIG_DISPLAY_ENABLE_CURSOR_MODE) || defined(CONFIG_DISPLAY_FIX_FLIP_VERTICALLY)
-    shadow_ram_[shadow_ram_index_++] = static_cast<char>(c);
-#endif
-    const uint8_t* base = kOledFont8x6 + (ssd1306::oled::font8x6::kCharW + 1) * i;
-    SendData(base, ssd1306::oled::font8x6::kCharW + 1);
+void Ssd1306::PutChar(int c) {
+    const auto kC = static_cast<char>(c);
+    WriteCells(&kC, 1);
 }
 
 void Ssd1306::PutString(const char* string) {
-    const char* p = string;
-
-    while (*p != '\0') {
-        Ssd1306::PutChar(static_cast<int>(*p));
-        p++;
-    }
-
-    if (clear_end_of_line_) {
-        clear_end_of_line_ = false;
-        for (auto i = static_cast<uint32_t>(p - string); i < cols_; i++) {
-            Ssd1306::PutChar(' ');
-        }
-    }
+    WriteText(string, static_cast<uint32_t>(strlen(string)));
 }
 
 /**
@@ -388,12 +388,8 @@ void Ssd1306::ClearLine(uint32_t line) {
     }
 
     Ssd1306::SetCursorPos(0, static_cast<uint8_t>(line - 1));
-    SendData(reinterpret_cast<const uint8_t*>(&s_clear_buffer), ssd1306::kLcdWidth + 1);
+    WriteCells(ssd1306::oled::font8x6::kSpaces, kColumns);
     Ssd1306::SetCursorPos(0, static_cast<uint8_t>(line - 1));
-
-#if defined(CONFIG_DISPLAY_ENABLE_CURSOR_MODE) || defined(CONFIG_DISPLAY_FIX_FLIP_VERTICALLY)
-    memset(&shadow_ram_[shadow_ram_index_], ' ', ssd1306::oled::font8x6::kCols);
-#endif
 }
 
 void Ssd1306::TextLine(uint32_t line, const char* data, uint32_t length) {
@@ -406,24 +402,111 @@ void Ssd1306::TextLine(uint32_t line, const char* data, uint32_t length) {
 }
 
 void Ssd1306::Text(const char* data, uint32_t length) {
-    if (length > cols_) {
-        length = cols_;
-    }
+    WriteText(data, std::min(length, cols_));
+}
 
-    uint32_t i;
+/*
+ * With ClearEndOfLine() the text and the trailing spaces are written at once,
+ * so a text line is sent as a single burst.
+ */
+void Ssd1306::WriteText(const char* data, uint32_t length) {
+    if (clear_end_of_line_) {
+        clear_end_of_line_ = false;
+
+        const auto kColumn = shadow_ram_index_ % kColumns;
 
-    for (i = 0; i < length; i++) {
-        Ssd1306::PutChar(data[i]);
+        if ((kColumn + length) < kColumns) {
+            char line[kColumns];
+            memcpy(line, data, length);
+            memcpy(&line[length], ssd1306::oled::font8x6::kSpaces, kColumns - kColumn - length);
+            WriteCells(line, kColumns - kColumn);
+            return;
+        }
     }
 
-    if (clear_end_of_line_) {
-        clear_end_of_line_ = false;
-        for (; i < cols_; i++) {
-            Ssd1306::PutChar(' ');
+    WriteCells(data, length);
+}
+
+/*
+ * Writes at the cursor, which wraps at the end of a text line.
+ * Only the characters which differ from the shadow RAM are sent: per text line
+ * the glyphs from the first to the last changed character go out as one burst.
+ */
+void Ssd1306::WriteCells(const char* data, uint32_t length) {
+    while (length != 0) {
+        const auto kRow = shadow_ram_index_ / kColumns;
+        const auto kColumn = shadow_ram_index_ % kColumns;
+        const auto kCount = std::min(length, kColumns - kColumn);
+
+        auto* shadow = &shadow_ram_[shadow_ram_index_];
+        uint32_t first = kCount;
+        uint32_t last = 0;
+
+        for (uint32_t i = 0; i < kCount; i++) {
+            auto c = data[i];
+
+            if ((static_cast<uint8_t>(c) < 32) || (static_cast<uint8_t>(c) > 127)) {
+                c = ' ';
+            }
+
+            if (shadow[i] != c) {
+                shadow[i] = c;
+                memcpy(&page_ram_[kRow][1 + (kColumn + i) * kCharW], ssd1306::oled::font8x6::kAtlas.glyph[c - 32], kCharW);
+                first = std::min(first, i);
+                last = i;
+            }
+        }
+
+        if (first <= last) {
+            SendLine(kRow, kColumn + first, kColumn + last + 1);
+        }
+
+        data += kCount;
+        length -= kCount;
+        shadow_ram_index_ += kCount;
+
+        if (shadow_ram_index_ >= (kColumns * rows_)) {
+            shadow_ram_index_ = 0;
         }
     }
 }
 
+/*
+ * Sends the glyph columns of the characters [first, end) of a text line.
+ * The control byte is stored in front of the line, elsewhere the column before
+ * the burst is borrowed. With CONFIG_I2C_ASYNC the queued burst points into
+ * page_ram_, so it always starts at the control byte of the line.
+ */
+void Ssd1306::SendLine(uint32_t row, uint32_t first, uint32_t end) {
+#if defined(CONFIG_I2C_ASYNC)
+    first = 0;
+#endif
+    SetAddress(first * kCharW, row);
+
+    auto* data = &page_ram_[row][first * kCharW];
+    const auto kLength = 1 + (end - first) * kCharW;
+#if defined(CONFIG_I2C_ASYNC)
+    SendData(data, kLength);
+#else
+    const auto kColumn = data[0];
+    data[0] = ssd1306::mode::kData;
+    SendData(data, kLength);
+    data[0] = kColumn;
+#endif
+}
+
+/*
+ * The column and the page in a single command transaction.
+ */
+void Ssd1306::SetAddress(uint32_t column, uint32_t page) {
+    if (have_sh1106_) {
+        column += 4;
+    }
+
+    const uint8_t kCommands[] = {ssd1306::mode::kCommand, static_cast<uint8_t>(ssd1306::cmd::kSetLowcolumn | (column & 0xF)), static_cast<uint8_t>(ssd1306::cmd::kSetHighcolumn | (column >> 4)), static_cast<uint8_t>(ssd1306::cmd::kSetStartpage | page)};
+    SendData(kCommands, sizeof(kCommands));
+}
+
 /**
  * (0,0)
  */
@@ -432,19 +515,8 @@ void Ssd1306::SetCursorPos(uint32_t column, uint32_t row) {
         return;
     }
 
-    column = static_cast<uint8_t>(column * ssd1306::oled::font8x6::kCharW);
-
-    if (have_sh1106_) {
-        column = static_cast<uint8_t>(column + 4);
-    }
-
-    SendCommand(ssd1306::cmd::kSetLowcolumn | (column & 0XF));
-    SendCommand(static_cast<uint8_t>(ssd1306::cmd::kSetHighcolumn | (column >> 4)));
-    SendCommand(static_cast<uint8_t>(ssd1306::cmd::kSetStartpage | row));
+    shadow_ram_index_ = (row * kColumns) + column;
 
-#if defined(CONFIG_DISPLAY_ENABLE_CURSOR_MODE) || defined(CONFIG_DISPLAY_FIX_FLIP_VERTICALLY)
-    shadow_ram_index_ = static_cast<uint16_t>((row * ssd1306::oled::font8x6::kCols) + (column / ssd1306::oled::font8x6::kCharW));
-#endif
 #if defined(CONFIG_DISPLAY_ENABLE_CURSOR_MODE)
     if (cursor_mode_ == display::cursor::kOn) {
         SetCursorOff();
@@ -479,13 +551,8 @@ void Ssd1306::SetFlipVertically(bool do_flip_vertically) {
     }
 
 #if defined(CONFIG_DISPLAY_FIX_FLIP_VERTICALLY)
-    for (uint32_t i = 0; i < rows_; i++) {
-        Ssd1306::SetCursorPos(0, static_cast<uint8_t>(i));
-        for (uint32_t j = 0; j < ssd1306::oled::font8x6::kCols; j++) {
-            const auto kN = shadow_ram_[i * ssd1306::oled::font8x6::kCols + j] - 32;
-            const uint8_t* base = kOledFont8x6 + (ssd1306::oled::font8x6::kCharW + 1) * kN;
-            SendData(base, ssd1306::oled::font8x6::kCharW + 1);
-        }
+    for (uint32_t row = 0; row < rows_; row++) {
+        SendLine(row, 0, kColumns);
     }
 #endif
 }
@@ -509,19 +576,34 @@ void Ssd1306::InitMembers() {
 
     pages_ = (oled_panel_ == OledPanel::k128x648Rows ? 8 : 4);
 
-#if defined(CONFIG_DISPLAY_ENABLE_CURSOR_MODE) || defined(CONFIG_DISPLAY_FIX_FLIP_VERTICALLY)
-    shadow_ram_ = new char[ssd1306::oled::font8x6::kCols * rows_];
-    assert(shadow_ram_ != nullptr);
-    memset(shadow_ram_, ' ', ssd1306::oled::font8x6::kCols * rows_);
-#endif
+    assert(rows_ <= kRowsMax);
+    static_assert(kColumns == ssd1306::oled::font8x6::kCols);
+    static_assert(kCharW == ssd1306::oled::font8x6::kCharW);
+
+    memset(shadow_ram_, ' ', sizeof(shadow_ram_));
+
+    for (auto& line : page_ram_) {
+        line[0] = ssd1306::mode::kData;
+        memset(&line[1], 0, kLineSize - 1);
+    }
 }
 
+// With CONFIG_I2C_ASYNC the writes are queued, the data is either copied or static
 void Ssd1306::SendCommand(uint8_t cmd) {
+#if defined(CONFIG_I2C_ASYNC)
+    const char kBuffer[] = {static_cast<char>(ssd1306::mode::kCommand), static_cast<char>(cmd)};
+    i2c_.Post(kBuffer, sizeof(kBuffer));
+#else
     i2c_.WriteRegister(ssd1306::mode::kCommand, cmd, true);
+#endif
 }
 
 void Ssd1306::SendData(const uint8_t* data, uint32_t length) {
+#if defined(CONFIG_I2C_ASYNC)
+    i2c_.Post(reinterpret_cast<const char*>(data), length);
+#else
     i2c_.Write(reinterpret_cast<const char*>(data), length);
+#endif
 }
 
 /**
@@ -554,80 +636,61 @@ void Ssd1306::SetCursor([[maybe_unused]] uint32_t cursor_mode) {
 
 void Ssd1306::SetCursorOn() {
 #if defined(CONFIG_DISPLAY_ENABLE_CURSOR_MODE)
-    cursor_on_column_ = static_cast<uint8_t>(shadow_ram_index_ % ssd1306::oled::font8x6::kCols);
-    cursor_on_row_ = static_cast<uint8_t>(shadow_ram_index_ / ssd1306::oled::font8x6::kCols);
+    cursor_on_column_ = static_cast<uint8_t>(shadow_ram_index_ % kColumns);
+    cursor_on_row_ = static_cast<uint8_t>(shadow_ram_index_ / kColumns);
     cursor_on_char_ = static_cast<uint8_t>(shadow_ram_[shadow_ram_index_] - 32);
 
-    const auto* base = const_cast<uint8_t*>(kOledFont8x6) + 1 + (ssd1306::oled::font8x6::kCharW + 1) * cursor_on_char_;
+    const auto* glyph = ssd1306::oled::font8x6::kAtlas.glyph[cursor_on_char_];
 
-    uint8_t data[ssd1306::oled::font8x6::kCharW + 1];
-    data[0] = 0x40;
+    uint8_t data[kCharW + 1];
+    data[0] = ssd1306::mode::kData;
 
-    for (uint32_t i = 1; i <= ssd1306::oled::font8x6::kCharW; i++) {
-        data[i] = *base | 0x80;
-        base++;
+    for (uint32_t i = 0; i < kCharW; i++) {
+        data[i + 1] = glyph[i] | 0x80;
     }
 
-    SendData(data, ssd1306::oled::font8x6::kCharW + 1);
     SetColumnRow(cursor_on_column_, cursor_on_row_);
+    SendData(data, sizeof(data));
 #endif
 }
 
 void Ssd1306::SetCursorBlinkOn() {
 #if defined(CONFIG_DISPLAY_ENABLE_CURSOR_MODE)
-    cursor_on_column_ = static_cast<uint8_t>(shadow_ram_index_ % ssd1306::oled::font8x6::kCols);
-    cursor_on_row_ = static_cast<uint8_t>(shadow_ram_index_ / ssd1306::oled::font8x6::kCols);
+    cursor_on_column_ = static_cast<uint8_t>(shadow_ram_index_ % kColumns);
+    cursor_on_row_ = static_cast<uint8_t>(shadow_ram_index_ / kColumns);
     cursor_on_char_ = static_cast<uint8_t>(shadow_ram_[shadow_ram_index_] - 32);
 
-    const uint8_t* base = const_cast<uint8_t*>(kOledFont8x6) + 1 + (ssd1306::oled::font8x6::kCharW + 1) * cursor_on_char_;
+    const auto* glyph = ssd1306::oled::font8x6::kAtlas.glyph[cursor_on_char_];
 
-    uint8_t data[ssd1306::oled::font8x6::kCharW + 1];
-    data[0] = 0x40;
+    uint8_t data[kCharW + 1];
+    data[0] = ssd1306::mode::kData;
 
-    for (uint32_t i = 1; i <= ssd1306::oled::font8x6::kCharW; i++) {
-        data[i] = static_cast<uint8_t>(~*base);
-        base++;
+    for (uint32_t i = 0; i < kCharW; i++) {
+        data[i + 1] = static_cast<uint8_t>(~glyph[i]);
     }
 
-    SendData(data, static_cast<uint32_t>(ssd1306::oled::font8x6::kCharW + 1));
     SetColumnRow(cursor_on_column_, cursor_on_row_);
+    SendData(data, sizeof(data));
 #endif
 }
 
 void Ssd1306::SetCursorOff() {
 #if defined(CONFIG_DISPLAY_ENABLE_CURSOR_MODE)
-    const auto kCol = static_cast<uint8_t>(shadow_ram_index_ % ssd1306::oled::font8x6::kCols);
-    const auto kRow = static_cast<uint8_t>(shadow_ram_index_ / ssd1306::oled::font8x6::kCols);
-
-    SetColumnRow(cursor_on_column_, cursor_on_row_);
-
-    const uint8_t* base = kOledFont8x6 + (ssd1306::oled::font8x6::kCharW + 1) * cursor_on_char_;
-
-    SendData(base, (ssd1306::oled::font8x6::kCharW + 1));
-    SetColumnRow(kCol, kRow);
+    // The cell could have been written meanwhile, the line RAM has the glyph on the panel
+    SendLine(cursor_on_row_, cursor_on_column_, cursor_on_column_ + 1U);
 #endif
 }
 
 void Ssd1306::SetColumnRow([[maybe_unused]] uint8_t column, [[maybe_unused]] uint8_t row) {
 #if defined(CONFIG_DISPLAY_ENABLE_CURSOR_MODE)
-    auto column_add = static_cast<uint8_t>(column * ssd1306::oled::font8x6::kCharW);
-
-    if (have_sh1106_) {
-        column_add = static_cast<uint8_t>(column_add + 4);
-    }
-
-    SendCommand(ssd1306::cmd::kSetLowcolumn | (column_add & 0xF));
-    SendCommand(ssd1306::cmd::kSetHighcolumn | static_cast<uint8_t>(column_add >> 4));
-    SendCommand(ssd1306::cmd::kSetStartpage | row);
+    SetAddress(column * kCharW, row);
 #endif
 }
 
 void Ssd1306::DumpShadowRam() {
-#if defined(CONFIG_DISPLAY_ENABLE_CURSOR_MODE) || defined(CONFIG_DISPLAY_FIX_FLIP_VERTICALLY)
 #ifndef NDEBUG
     for (uint32_t i = 0; i < rows_; i++) {
-        printf("%d: [%.*s]\n", i, ssd1306::oled::font8x6::kCols, &shadow_ram_[i * ssd1306::oled::font8x6::kCols]);
+        printf("%u: [%.*s]\n", static_cast<unsigned>(i), static_cast<int>(kColumns), &shadow_ram_[i * kColumns]);
     }
 #endif
-#endif
 }
@@ -29,6 +29,7 @@
 
 #include "flashcode.h"
 #include "gd32.h"
+#include "firmware/debug/debug_timeline.h"
 
 /**
  * With the latest GD32F firmware, this function is declared as static.
@@ -206,6 +207,8 @@ bool FlashCode::Erase(uint32_t offset, uint32_t length, flashcode::Result& resul
 }
 
 bool FlashCode::Write(uint32_t offset, uint32_t length, const uint8_t* pBuffer, flashcode::Result& result) {
+    debug::timeline::Scope timeline(debug::timeline::Id::kFlashWrite);
+
     result = Result::kOk;
 
     switch (s_state) {
@@ -31,6 +31,7 @@
 #include "flashcode.h"
 #include "gd32.h"
 #include "firmware/debug/debug_debug.h"
+#include "firmware/debug/debug_timeline.h"
 
 namespace {
 // Backwards compatibility with SPI FLASH
@@ -134,6 +135,8 @@ bool FlashCode::Erase(uint32_t offset, uint32_t length, flashcode::Result& resul
 }
 
 bool FlashCode::Write(uint32_t offset, uint32_t length, const uint8_t* buffer, flashcode::Result& result) {
+    debug::timeline::Scope timeline(debug::timeline::Id::kFlashWrite);
+
     if ((s_state == State::WRITE_PROGRAM) || (s_state == State::WRITE_BUSY)) {
     } else {
         DEBUG_ENTRY();
@@ -60,10 +60,12 @@ bool FlashCodeInstall::WriteFirmware(const uint8_t* buffer, uint32_t size) {
     FLASHCODE_INSTALL_DEBUG_PRINTF("size=%x, kSectorSize=%x, kEraseSize=%x", static_cast<unsigned>(size), static_cast<unsigned>(kSectorSize), static_cast<unsigned>(kEraseSize));
 
     Display::Get()->TextStatus("Erase", ansi::Colours::Colour::kGreen);
+    Display::Get()->Flush();
 
     flashcode::Result result;
 
     while (!FlashCode::Erase(OFFSET_UIMAGE, kEraseSize, result)) {
+        Display::Get()->Run();
     }
 
     if (flashcode::Result::kError == result) {
@@ -72,8 +74,10 @@ bool FlashCodeInstall::WriteFirmware(const uint8_t* buffer, uint32_t size) {
     }
 
     Display::Get()->TextStatus("Writing", ansi::Colours::Colour::kGreen);
+    Display::Get()->Flush();
 
     while (!FlashCode::Write(OFFSET_UIMAGE, size, buffer, result)) {
+        Display::Get()->Run();
     }
 
     if (flashcode::Result::kError == result) {
@@ -86,6 +90,7 @@ bool FlashCodeInstall::WriteFirmware(const uint8_t* buffer, uint32_t size) {
     }
 
     Display::Get()->TextStatus("Done", ansi::Colours::Colour::kGreen);
+    Display::Get()->Flush();
 
     FLASHCODE_INSTALL_DEBUG_EXIT();
     return true;
@@ -112,8 +117,11 @@ bool FlashCodeInstall::Erase(uint32_t firmware_size) {
     while (!FlashCode::Erase(OFFSET_UIMAGE, erase_size_, result)) {
         watchdog::Feed();
         Display::Get()->Progress();
+        Display::Get()->Run();
     }
 
+    Display::Get()->Flush();
+
     putchar('\n');
 
     if (flashcode::Result::kOk == result) {
@@ -130,6 +138,7 @@ bool FlashCodeInstall::WriteChunk(const uint8_t* chunck, uint32_t chunk_size, ui
     flashcode::Result result;
     while (!FlashCode::Write(OFFSET_UIMAGE + write_count_, chunk_size, chunck, result)) {
         watchdog::Feed();
+        Display::Get()->Run();
     }
 
     write_count_ += chunk_size;
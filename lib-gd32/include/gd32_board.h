@@ -115,6 +115,16 @@ void emac_debug_run();
 
 #include "softwaretimers.h" // IWYU pragma: keep
 #include "panelled.h"
+#if defined(CONFIG_I2C_ASYNC)
+#include "gd32_i2c_async.h"
+#endif // defined(CONFIG_I2C_ASYNC)
+#if defined(CONFIG_SUPERLOOP_EVENT_DRIVEN)
+#if !defined(CONFIG_HAL_USE_SYSTICK)
+#error CONFIG_SUPERLOOP_EVENT_DRIVEN needs the SysTick wake-up
+#endif // !defined(CONFIG_HAL_USE_SYSTICK)
+#include "superloop_event.h"
+#include "timing.h"
+#endif // defined(CONFIG_SUPERLOOP_EVENT_DRIVEN)
 
 namespace board {
 inline void Run() {
@@ -125,6 +135,9 @@ inline void Run() {
     SoftwareTimerRun();
 #endif // !defined(USE_FREE_RTOS)
     panelled::Run();
+#if defined(CONFIG_I2C_ASYNC)
+    i2c::async::Run();
+#endif // defined(CONFIG_I2C_ASYNC)
 #if defined(CONFIG_DEBUG_STACK)
     debug::stack::Run();
 #endif // defined(CONFIG_DEBUG_STACK)
@@ -132,6 +145,30 @@ inline void Run() {
     emac_debug_run();
 #endif // defined(DEBUG_EMAC)
 }
+
+/*
+ * Called at the end of the superloop. Sleeps until an event flag is set, the
+ * next software timer expires or superloop::event::kIdleMillisMax has passed.
+ * The 1 kHz SysTick wakes the core for the deadline check. With PRIMASK set an
+ * interrupt still ends the WFI, it is serviced when interrupts are re-enabled.
+ */
+inline void Idle() {
+#if defined(CONFIG_SUPERLOOP_EVENT_DRIVEN)
+    const auto kDeadline = timing::Millis() + SoftwareTimerNextExpire(superloop::event::kIdleMillisMax);
+
+    __disable_irq();
+
+    while ((superloop::event::global::flags == 0) && (static_cast<int32_t>(timing::Millis() - kDeadline) < 0)) {
+        __WFI();
+        __enable_irq();
+        __disable_irq();
+    }
+
+    superloop::event::global::flags = 0;
+
+    __enable_irq();
+#endif // defined(CONFIG_SUPERLOOP_EVENT_DRIVEN)
+}
 } // namespace board
 #endif // __cplusplus
 
@@ -31,6 +31,10 @@
 
 #include "gd32.h"
 
+#if defined(GD32F20X) && defined(CONFIG_USART0_ENABLE_TX_DMA)
+#error "dma::memcpy32 and the USART0 TX DMA both use DMA0 channel 3"
+#endif
+
 namespace dma::memcpy32
 {
 void Init();
@@ -0,0 +1,88 @@
+/**
+ * @file gd32_i2c_async.h
+ *
+ */
+/* Copyright (C) 2026 by Arjan van Vught mailto:info@gd32-dmx.org
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef GD32_I2C_ASYNC_H_
+#define GD32_I2C_ASYNC_H_
+
+#include <cstdint>
+
+/*
+ * Queued I2C master transactions on I2C_PERIPH (CONFIG_I2C_ASYNC).
+ * An interrupt state machine sends the start, address and stop conditions,
+ * the payloads are moved by DMA. The transactions run in submit order, a
+ * write and a read in one transaction are joined with a repeated start.
+ * The callbacks are called from Run(), i.e. in thread context.
+ * The blocking Gd32I2c* functions for I2C_PERIPH use Transfer().
+ */
+namespace i2c::async {
+enum class Status : uint8_t { kPending, kOk, kNack, kArbitrationLost, kBusError, kTimeout };
+
+using Callback = void (*)(void* context, Status status);
+
+inline constexpr uint32_t kInlineSize = 8; ///< Write data up to this size is copied at submit
+
+struct Transaction {
+    const uint8_t* tx;
+    uint8_t* rx;
+    Callback callback;
+    void* context;
+    uint16_t tx_length;
+    uint16_t rx_length;
+    uint8_t address; ///< 7-bit
+};
+
+void Init();
+void SetBaudrate(uint32_t baudrate);
+
+/**
+ * @brief Queues the transaction, waits only when the queue is full.
+ * The tx data longer than kInlineSize and the rx buffer must stay valid until
+ * the transaction is done.
+ */
+void Submit(const Transaction& transaction);
+
+inline void Post(uint8_t address, const uint8_t* data, uint32_t length) {
+    Submit({data, nullptr, nullptr, nullptr, static_cast<uint16_t>(length), 0, address});
+}
+
+/**
+ * @brief Synchronous wrapper, waits until the transaction (and the ones queued before) is done.
+ */
+Status Transfer(uint8_t address, const uint8_t* tx, uint32_t tx_length, uint8_t* rx, uint32_t rx_length);
+
+/**
+ * @brief Calls the callbacks of the completed transactions and handles the timeout.
+ */
+void Run();
+
+/**
+ * @brief Waits until the queue is empty.
+ */
+void Flush();
+
+[[nodiscard]] bool IsIdle();
+} // namespace i2c::async
+
+#endif // GD32_I2C_ASYNC_H_
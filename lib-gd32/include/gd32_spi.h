@@ -66,8 +66,10 @@ void Gd32SpiWritenb(const char* tx_buffer, uint32_t length);
  */
 
 // const uint8_t* Gd32SpiDmaTxPrepare(uint32_t& length);
-// void Gd32SpiDmaTxStart(const uint8_t* tx_buffer, uint32_t length);
-// bool Gd32SpiDmaTxIsActive();
+#if defined(CONFIG_SPI_ENABLE_TX_DMA)
+void Gd32SpiDmaTxStart(const uint8_t* tx_buffer, uint32_t length);
+bool Gd32SpiDmaTxIsActive();
+#endif
 
 /**
  * SPI DMA implementation using I2S.
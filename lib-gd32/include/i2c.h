@@ -38,6 +38,9 @@
 #include <cstdint>
 
 #include "gd32_i2c.h"
+#if defined(CONFIG_I2C_ASYNC)
+#include "gd32_i2c_async.h"
+#endif
 #include "timing.h"
 
 namespace i2c {
@@ -200,6 +203,17 @@ class I2c {
         return static_cast<uint16_t>(static_cast<uint16_t>(buffer[0]) << 8 | static_cast<uint16_t>(buffer[1]));
     }
 
+#if defined(CONFIG_I2C_ASYNC)
+    /**
+     * Queued write, returns without waiting for the bus.
+     * Data longer than i2c::async::kInlineSize must stay valid until it is sent.
+     */
+    void Post(const char* data, uint32_t length) {
+        Gd32I2cSetBaudrate(baudrate_);
+        i2c::async::Post(address_, reinterpret_cast<const uint8_t*>(data), length);
+    }
+#endif
+
     bool AckRead() {
         char buf;
         return Gd32I2cRead(&buf, 1) == 0;
@@ -340,6 +340,11 @@
  * DMA
  */
 
+#define I2C0_RCU_DMAx			RCU_DMA0
+#define I2C0_DMAx				DMA0
+#define I2C0_TX_DMA_CHx			DMA_CH5
+#define I2C0_RX_DMA_CHx			DMA_CH6
+
 #define SPI0_DMAx				DMA0
 #define SPI0_TX_DMA_CHx			DMA_CH2
 
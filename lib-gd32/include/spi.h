@@ -85,6 +85,16 @@ inline void Write(uint16_t data) {
 inline void Writenb(const char* tx_buffer, uint32_t length) {
     Gd32SpiWritenb(tx_buffer, length);
 }
+
+#if defined(CONFIG_SPI_ENABLE_TX_DMA)
+inline void DmaTxStart(const uint8_t* tx_buffer, uint32_t length) {
+    Gd32SpiDmaTxStart(tx_buffer, length);
+}
+
+inline bool DmaTxIsActive() {
+    return Gd32SpiDmaTxIsActive();
+}
+#endif
 } // namespace spi
 
 class Spi {
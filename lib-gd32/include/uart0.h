@@ -26,12 +26,29 @@
 #ifndef GD32_UART0_H_
 #define GD32_UART0_H_
 
+#include <cstdint>
+#include <cstdarg>
+
 namespace uart0 {
 void Init();
 void PutChar(int c);
+void Write(const char* s, uint32_t length);
 void Puts(const char* s);
 int Printf(const char* fmt, ...);
 int GetChar();
+#if defined(CONFIG_USART0_ENABLE_TX_DMA)
+/**
+ * @brief Waits until the TX ring is sent, e.g. before a reset.
+ */
+void Flush();
+/**
+ * @return The number of messages dropped because the TX ring was full.
+ */
+uint32_t TxDropped();
+#if defined(CONFIG_USART0_TX_DEFERRED)
+int Deferred(const char* fmt, va_list va);
+#endif
+#endif
 } // namespace uart0
 
 #endif // GD32_UART0_H_
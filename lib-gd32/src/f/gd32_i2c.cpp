@@ -36,6 +36,9 @@
 
 #include "gd32.h"
 #include "gd32_i2c.h"
+#if defined(CONFIG_I2C_ASYNC)
+#include "gd32_i2c_async.h"
+#endif
 
 static constexpr int32_t kTimeout = 0xfff;
 
@@ -129,7 +132,30 @@ template <uint32_t PERIPH> static int32_t SendData(const uint8_t* data, uint32_t
     return GD32_I2C_OK;
 }
 
+#if defined(CONFIG_I2C_ASYNC)
+static constexpr uint8_t ReturnCode(i2c::async::Status status) {
+    switch (status) {
+        case i2c::async::Status::kOk:
+            return GD32_I2C_OK;
+        case i2c::async::Status::kNack:
+            return GD32_I2C_NACK;
+        case i2c::async::Status::kArbitrationLost:
+            return GD32_I2C_NOK_LA;
+        case i2c::async::Status::kTimeout:
+            return GD32_I2C_NOK_TOUT;
+        default:
+            return GD32_I2C_NOK;
+    }
+}
+#endif
+
 template <uint32_t PERIPH> static int32_t WriteImplementation(const char* buffer, uint32_t length) {
+#if defined(CONFIG_I2C_ASYNC)
+    if constexpr (PERIPH == I2C_PERIPH) {
+        const auto kStatus = i2c::async::Transfer(static_cast<uint8_t>(GetAddress<PERIPH>() >> 1), reinterpret_cast<const uint8_t*>(buffer), length, nullptr, 0);
+        return -static_cast<int32_t>(ReturnCode(kStatus));
+    }
+#endif
     if (SendStart<PERIPH>() != GD32_I2C_OK) {
         SendStop<PERIPH>();
         return -1;
@@ -151,6 +177,11 @@ template <uint32_t PERIPH> static int32_t WriteImplementation(const char* buffer
 }
 
 template <uint32_t PERIPH> static uint8_t ReadImplementation(char* buffer, uint32_t length) {
+#if defined(CONFIG_I2C_ASYNC)
+    if constexpr (PERIPH == I2C_PERIPH) {
+        return ReturnCode(i2c::async::Transfer(static_cast<uint8_t>(GetAddress<PERIPH>() >> 1), nullptr, 0, reinterpret_cast<uint8_t*>(buffer), length));
+    }
+#endif
     auto timeout = kTimeout;
 
     while (i2c_flag_get(PERIPH, I2C_FLAG_I2CBSY)) {
@@ -354,10 +385,17 @@ void Gd32I2cBegin() {
     RcuConfigI2c();
     GpioConfigI2c();
     I2cConfig<I2C_PERIPH>();
+#if defined(CONFIG_I2C_ASYNC)
+    i2c::async::Init();
+#endif
 }
 
 void Gd32I2cSetBaudrate(uint32_t baudrate) {
+#if defined(CONFIG_I2C_ASYNC)
+    i2c::async::SetBaudrate(baudrate);
+#else
     i2c_clock_config(I2C_PERIPH, baudrate, I2C_DTCY_2);
+#endif
 }
 
 void Gd32I2cSetAddress(uint8_t address) {
@@ -0,0 +1,429 @@
+/**
+ * @file gd32_i2c_async.cpp
+ *
+ */
+/* Copyright (C) 2026 by Arjan van Vught mailto:info@gd32-dmx.org
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#if defined(CONFIG_I2C_ASYNC)
+#if !defined(GD32F20X)
+#error "CONFIG_I2C_ASYNC is not supported"
+#endif
+
+#include <cstdint>
+#include <cstring>
+
+#include "gd32_i2c_async.h"
+#include "gd32_i2c.h"
+#include "gd32_dma.h"
+#include "gd32.h"
+#if defined(CONFIG_SUPERLOOP_EVENT_DRIVEN)
+#include "superloop_event.h"
+#endif
+
+#if !defined(CONFIG_I2C_ASYNC_QUEUE_SIZE)
+#define CONFIG_I2C_ASYNC_QUEUE_SIZE 16
+#endif
+
+// Clock stretching allowed per transaction, on top of twice the bus time
+#if !defined(CONFIG_I2C_ASYNC_STRETCH_MICROS)
+#define CONFIG_I2C_ASYNC_STRETCH_MICROS 1000
+#endif
+
+#define I2C0_TX_DMA_IRQn DMA0_Channel5_IRQn
+#define I2C0_TX_DMA_IRQ_HANDLER DMA0_Channel5_IRQHandler
+#define I2C0_RX_DMA_IRQn DMA0_Channel6_IRQn
+#define I2C0_RX_DMA_IRQ_HANDLER DMA0_Channel6_IRQHandler
+
+static_assert(I2C_PERIPH == I2C0, "The DMA channels are those of I2C0");
+
+namespace i2c::async {
+static constexpr uint32_t kQueueSize = CONFIG_I2C_ASYNC_QUEUE_SIZE;
+static_assert((kQueueSize & (kQueueSize - 1)) == 0, "CONFIG_I2C_ASYNC_QUEUE_SIZE must be a power of 2");
+static constexpr uint32_t kStretchMicros = CONFIG_I2C_ASYNC_STRETCH_MICROS;
+static constexpr int32_t kStopTimeout = 0xfff;
+
+struct Entry {
+    Transaction transaction;
+    uint8_t data[kInlineSize];
+    volatile Status status;
+};
+
+/*
+ * Ring with free running indices. Submit() adds at the head, the interrupts
+ * complete the transaction at sv_active and start the next one, Run() calls
+ * the callbacks and releases the entries at the tail.
+ * The four interrupts have the same priority, they do not preempt each other.
+ * Note: USART1 and TIMER0/TIMER2 can use the same DMA channels.
+ */
+static Entry s_queue[kQueueSize];
+static volatile uint32_t sv_head;
+static volatile uint32_t sv_active;
+static uint32_t s_tail;
+static volatile bool sv_is_busy;           ///< A transaction is on the bus
+static volatile bool sv_is_reading;        ///< Read phase of the active transaction
+static volatile uint32_t sv_start_cycles;  ///< DWT->CYCCNT at the last progress, it also counts with interrupts disabled
+static volatile uint32_t sv_timeout_cycles;
+static uint32_t s_baudrate = gd32::kI2CFullSpeed;
+
+static Entry& Active() {
+    return s_queue[sv_active & (kQueueSize - 1)];
+}
+
+template <dma_channel_enum kChannel> static void DmaStart(const uint8_t* buffer, uint32_t length) {
+    DMA_CHCTL(I2C0_DMAx, kChannel) &= ~DMA_CHXCTL_CHEN;
+    DMA_CHMADDR(I2C0_DMAx, kChannel) = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(buffer));
+    Gd32DmaInterruptFlagClear<I2C0_DMAx, kChannel, DMA_INTERRUPT_FLAG_CLEAR>();
+    DMA_CHCNT(I2C0_DMAx, kChannel) = length;
+    DMA_CHCTL(I2C0_DMAx, kChannel) |= DMA_CHXCTL_CHEN;
+}
+
+template <dma_channel_enum kChannel> static void DmaStop() {
+    DMA_CHCTL(I2C0_DMAx, kChannel) &= ~DMA_CHXCTL_CHEN;
+    Gd32DmaInterruptFlagClear<I2C0_DMAx, kChannel, DMA_INTERRUPT_FLAG_CLEAR>();
+}
+
+/*
+ * 9 clocks per byte plus the address byte(s), start, repeated start and stop.
+ * The timeout is twice the bus time plus kStretchMicros, in CPU cycles.
+ * It runs from the last progress, so a transaction delayed by a CPU stall
+ * (flash erase) is not aborted as long as it moves on.
+ */
+static uint32_t TimeoutCycles(const Transaction& transaction) {
+    const auto kClocks = (static_cast<uint64_t>(transaction.tx_length) + transaction.rx_length + 2U) * 9U + 3U;
+    const auto kCycles = (2U * kClocks * MCU_CLOCK_FREQ) / s_baudrate + static_cast<uint64_t>(kStretchMicros) * (MCU_CLOCK_FREQ / 1000000U);
+
+    return (kCycles < (UINT32_MAX / 2)) ? static_cast<uint32_t>(kCycles) : (UINT32_MAX / 2);
+}
+
+static void Progress() {
+    sv_start_cycles = DWT->CYCCNT;
+}
+
+static void Configure() {
+    i2c_clock_config(I2C_PERIPH, s_baudrate, I2C_DTCY_2);
+    i2c_enable(I2C_PERIPH);
+    i2c_ack_config(I2C_PERIPH, I2C_ACK_ENABLE);
+}
+
+static void Start() {
+    const auto& transaction = Active().transaction;
+
+    // The stop condition of the previous transaction can still be pending
+    auto timeout = kStopTimeout;
+    while ((I2C_CTL0(I2C_PERIPH) & I2C_CTL0_STOP) && (--timeout > 0)) {
+    }
+
+    sv_is_reading = (transaction.tx_length == 0) && (transaction.rx_length != 0);
+    sv_timeout_cycles = TimeoutCycles(transaction);
+    Progress();
+
+    I2C_CTL0(I2C_PERIPH) = (I2C_CTL0(I2C_PERIPH) & ~I2C_CTL0_POAP) | I2C_CTL0_ACKEN;
+    I2C_CTL1(I2C_PERIPH) |= (I2C_CTL1_EVIE | I2C_CTL1_ERRIE);
+    i2c_start_on_bus(I2C_PERIPH);
+}
+
+static void Complete(Status status) {
+    I2C_CTL1(I2C_PERIPH) &= ~(I2C_CTL1_EVIE | I2C_CTL1_ERRIE | I2C_CTL1_BUFIE | I2C_CTL1_DMAON | I2C_CTL1_DMALST);
+
+    Active().status = status;
+    sv_active = sv_active + 1;
+
+#if defined(CONFIG_SUPERLOOP_EVENT_DRIVEN)
+    superloop::event::Set(superloop::event::kPeripheral);
+#endif
+
+    if (sv_active != sv_head) {
+        Start();
+    } else {
+        sv_is_busy = false;
+    }
+}
+
+static void Abort(Status status) {
+    DmaStop<I2C0_TX_DMA_CHx>();
+    DmaStop<I2C0_RX_DMA_CHx>();
+
+    if (status != Status::kArbitrationLost) {
+        i2c_stop_on_bus(I2C_PERIPH);
+    }
+
+    Complete(status);
+}
+
+// A slave stretching the clock forever, or a lost interrupt
+static void Recover() {
+    DmaStop<I2C0_TX_DMA_CHx>();
+    DmaStop<I2C0_RX_DMA_CHx>();
+
+    i2c_software_reset_config(I2C_PERIPH, I2C_SRESET_SET);
+    i2c_software_reset_config(I2C_PERIPH, I2C_SRESET_RESET);
+    Configure();
+
+    Complete(Status::kTimeout);
+}
+} // namespace i2c::async
+
+using namespace i2c::async;
+
+extern "C" void I2C0_EV_IRQHandler() {
+    const auto kStat0 = I2C_STAT0(I2C_PERIPH);
+    auto& transaction = Active().transaction;
+
+    if (kStat0 & I2C_STAT0_SBSEND) {
+        Progress();
+        i2c_master_addressing(I2C_PERIPH, static_cast<uint32_t>(transaction.address << 1), sv_is_reading ? I2C_RECEIVER : I2C_TRANSMITTER);
+        return;
+    }
+
+    if (kStat0 & I2C_STAT0_ADDSEND) {
+        Progress();
+        // ADDSEND is cleared by reading STAT0 and then STAT1
+        if (!sv_is_reading) {
+            if (transaction.tx_length == 0) { // Address probe
+                I2C_STAT1(I2C_PERIPH);
+                i2c_stop_on_bus(I2C_PERIPH);
+                Complete(Status::kOk);
+                return;
+            }
+
+            // BTC is awaited when the DMA is done
+            DmaStart<I2C0_TX_DMA_CHx>(transaction.tx, transaction.tx_length);
+            I2C_CTL1(I2C_PERIPH) = (I2C_CTL1(I2C_PERIPH) & ~I2C_CTL1_EVIE) | I2C_CTL1_DMAON;
+            I2C_STAT1(I2C_PERIPH);
+            return;
+        }
+
+        if (transaction.rx_length == 1) {
+            I2C_CTL0(I2C_PERIPH) &= ~I2C_CTL0_ACKEN;
+            I2C_STAT1(I2C_PERIPH);
+            i2c_stop_on_bus(I2C_PERIPH);
+            I2C_CTL1(I2C_PERIPH) |= I2C_CTL1_BUFIE;
+            return;
+        }
+
+        // DMALST: the last byte is not acknowledged
+        DmaStart<I2C0_RX_DMA_CHx>(transaction.rx, transaction.rx_length);
+        I2C_CTL1(I2C_PERIPH) = (I2C_CTL1(I2C_PERIPH) & ~I2C_CTL1_EVIE) | I2C_CTL1_DMAON | I2C_CTL1_DMALST;
+        I2C_STAT1(I2C_PERIPH);
+        return;
+    }
+
+    if (sv_is_reading) {
+        if (kStat0 & I2C_STAT0_RBNE) {
+            transaction.rx[0] = static_cast<uint8_t>(I2C_DATA(I2C_PERIPH));
+            Complete(Status::kOk);
+        }
+        return;
+    }
+
+    if (kStat0 & I2C_STAT0_BTC) {
+        Progress();
+
+        if (transaction.rx_length != 0) {
+            sv_is_reading = true;
+            i2c_start_on_bus(I2C_PERIPH); // Repeated start
+            return;
+        }
+
+        i2c_stop_on_bus(I2C_PERIPH);
+        Complete(Status::kOk);
+    }
+}
+
+extern "C" void I2C0_ER_IRQHandler() {
+    const auto kStat0 = I2C_STAT0(I2C_PERIPH);
+
+    I2C_STAT0(I2C_PERIPH) &= ~(I2C_STAT0_BERR | I2C_STAT0_LOSTARB | I2C_STAT0_AERR | I2C_STAT0_OUERR | I2C_STAT0_PECERR | I2C_STAT0_SMBTO | I2C_STAT0_SMBALT);
+
+    if (!sv_is_busy) {
+        return;
+    }
+
+    if (kStat0 & I2C_STAT0_AERR) {
+        Abort(Status::kNack);
+    } else if (kStat0 & I2C_STAT0_LOSTARB) {
+        Abort(Status::kArbitrationLost);
+    } else if (kStat0 & I2C_STAT0_BERR) {
+        Abort(Status::kBusError);
+    }
+}
+
+extern "C" void I2C0_TX_DMA_IRQ_HANDLER() {
+    if (Gd32DmaInterruptFlagGet<I2C0_DMAx, I2C0_TX_DMA_CHx, DMA_INTERRUPT_FLAG_GET>()) {
+        DmaStop<I2C0_TX_DMA_CHx>();
+        Progress();
+        I2C_CTL1(I2C_PERIPH) = (I2C_CTL1(I2C_PERIPH) & ~I2C_CTL1_DMAON) | I2C_CTL1_EVIE;
+    }
+}
+
+extern "C" void I2C0_RX_DMA_IRQ_HANDLER() {
+    if (Gd32DmaInterruptFlagGet<I2C0_DMAx, I2C0_RX_DMA_CHx, DMA_INTERRUPT_FLAG_GET>()) {
+        DmaStop<I2C0_RX_DMA_CHx>();
+        i2c_stop_on_bus(I2C_PERIPH);
+        Complete(Status::kOk);
+    }
+}
+
+namespace i2c::async {
+template <IRQn_Type kIrq> static bool IsPending() {
+    if (NVIC_GetPendingIRQ(kIrq) != 0) {
+        NVIC_ClearPendingIRQ(kIrq);
+        return true;
+    }
+    return false;
+}
+
+// Services the interrupts when they cannot run, i.e. with interrupts disabled
+static void Poll() {
+    if (IsPending<I2C0_ER_IRQn>()) I2C0_ER_IRQHandler();
+    if (IsPending<I2C0_EV_IRQn>()) I2C0_EV_IRQHandler();
+    if (IsPending<I2C0_TX_DMA_IRQn>()) I2C0_TX_DMA_IRQ_HANDLER();
+    if (IsPending<I2C0_RX_DMA_IRQn>()) I2C0_RX_DMA_IRQ_HANDLER();
+}
+
+template <dma_channel_enum kChannel> static void DmaInit(uint8_t direction) {
+    DMA_PARAMETER_STRUCT dma_init_struct;
+    dma_deinit(I2C0_DMAx, kChannel);
+    dma_struct_para_init(&dma_init_struct);
+    dma_init_struct.direction = direction;
+    dma_init_struct.memory_inc = DMA_MEMORY_INCREASE_ENABLE;
+    dma_init_struct.memory_width = DMA_MEMORY_WIDTH_8BIT;
+    dma_init_struct.periph_addr = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(&I2C_DATA(I2C_PERIPH)));
+    dma_init_struct.periph_inc = DMA_PERIPH_INCREASE_DISABLE;
+    dma_init_struct.periph_width = DMA_PERIPHERAL_WIDTH_8BIT;
+    dma_init_struct.priority = DMA_PRIORITY_LOW;
+    dma_init(I2C0_DMAx, kChannel, &dma_init_struct);
+    dma_circulation_disable(I2C0_DMAx, kChannel);
+    dma_memory_to_memory_disable(I2C0_DMAx, kChannel);
+    dma_interrupt_enable(I2C0_DMAx, kChannel, DMA_INTERRUPT_ENABLE);
+}
+
+void Init() {
+    rcu_periph_clock_enable(I2C0_RCU_DMAx);
+
+    DmaInit<I2C0_TX_DMA_CHx>(DMA_MEMORY_TO_PERIPHERAL);
+    DmaInit<I2C0_RX_DMA_CHx>(DMA_PERIPHERAL_TO_MEMORY);
+
+    NVIC_SetPriority(I2C0_EV_IRQn, 2);
+    NVIC_EnableIRQ(I2C0_EV_IRQn);
+    NVIC_SetPriority(I2C0_ER_IRQn, 2);
+    NVIC_EnableIRQ(I2C0_ER_IRQn);
+    NVIC_SetPriority(I2C0_TX_DMA_IRQn, 2);
+    NVIC_EnableIRQ(I2C0_TX_DMA_IRQn);
+    NVIC_SetPriority(I2C0_RX_DMA_IRQn, 2);
+    NVIC_EnableIRQ(I2C0_RX_DMA_IRQn);
+}
+
+void SetBaudrate(uint32_t baudrate) {
+    if (baudrate == s_baudrate) {
+        return;
+    }
+
+    Flush();
+
+    s_baudrate = baudrate;
+    i2c_clock_config(I2C_PERIPH, baudrate, I2C_DTCY_2);
+}
+
+void Submit(const Transaction& transaction) {
+    while ((sv_head - s_tail) == kQueueSize) {
+        Run();
+    }
+
+    auto& entry = s_queue[sv_head & (kQueueSize - 1)];
+    entry.transaction = transaction;
+    entry.status = Status::kPending;
+
+    if ((transaction.tx_length != 0) && (transaction.tx_length <= kInlineSize)) {
+        memcpy(entry.data, transaction.tx, transaction.tx_length);
+        entry.transaction.tx = entry.data;
+    }
+
+    const auto kPrimask = __get_PRIMASK();
+    __disable_irq();
+
+    sv_head = sv_head + 1;
+
+    if (!sv_is_busy) {
+        sv_is_busy = true;
+        Start();
+    }
+
+    __set_PRIMASK(kPrimask);
+}
+
+static void Done(void* context, Status status) {
+    *static_cast<volatile Status*>(context) = status;
+}
+
+Status Transfer(uint8_t address, const uint8_t* tx, uint32_t tx_length, uint8_t* rx, uint32_t rx_length) {
+    volatile auto status = Status::kPending;
+
+    Submit({tx, rx, Done, const_cast<Status*>(&status), static_cast<uint16_t>(tx_length), static_cast<uint16_t>(rx_length), address});
+
+    while (status == Status::kPending) {
+        Run();
+    }
+
+    return status;
+}
+
+void Run() {
+    const auto kPrimask = __get_PRIMASK();
+
+    if (kPrimask != 0) {
+        Poll();
+    }
+
+    __disable_irq();
+
+    if (sv_is_busy && ((DWT->CYCCNT - sv_start_cycles) > sv_timeout_cycles)) {
+        Recover();
+    }
+
+    __set_PRIMASK(kPrimask);
+
+    while (s_tail != sv_active) {
+        const auto& entry = s_queue[s_tail & (kQueueSize - 1)];
+        const auto kCallback = entry.transaction.callback;
+        auto* context = entry.transaction.context;
+        const auto kStatus = entry.status;
+
+        s_tail++; // The callback can submit
+
+        if (kCallback != nullptr) {
+            kCallback(context, kStatus);
+        }
+    }
+}
+
+void Flush() {
+    while (!IsIdle()) {
+        Run();
+    }
+}
+
+bool IsIdle() {
+    return s_tail == sv_head;
+}
+} // namespace i2c::async
+#endif
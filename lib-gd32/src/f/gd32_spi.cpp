@@ -28,6 +28,9 @@
 
 #include "gd32_spi.h"
 #include "gd32_gpio.h"
+#if defined(CONFIG_SPI_ENABLE_TX_DMA)
+#include "gd32_dma.h"
+#endif
 #include "gd32.h"
 
 static uint8_t s_cs = GD32_SPI_CS0;
@@ -108,6 +111,47 @@ static void SpiConfig() {
     spi_enable(SPI_PERIPH);
 }
 
+#if defined(CONFIG_SPI_ENABLE_TX_DMA)
+static void DmaConfig() {
+    if constexpr (SPI_DMAx == DMA0) {
+        rcu_periph_clock_enable(RCU_DMA0);
+    } else {
+        rcu_periph_clock_enable(RCU_DMA1);
+    }
+
+    dma_deinit(SPI_DMAx, SPI_DMA_CHx);
+
+    DMA_PARAMETER_STRUCT dma_init_struct;
+    dma_struct_para_init(&dma_init_struct);
+
+    dma_init_struct.direction = DMA_MEMORY_TO_PERIPHERAL;
+    dma_init_struct.memory_inc = DMA_MEMORY_INCREASE_ENABLE;
+#if defined(GD32F4XX)
+#else
+    dma_init_struct.memory_width = DMA_MEMORY_WIDTH_8BIT;
+#endif
+    dma_init_struct.periph_addr = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(&SPI_DATA(SPI_PERIPH)));
+    dma_init_struct.periph_inc = DMA_PERIPH_INCREASE_DISABLE;
+#if defined(GD32F4XX)
+    dma_init_struct.periph_memory_width = DMA_PERIPHERAL_WIDTH_8BIT;
+#else
+    dma_init_struct.periph_width = DMA_PERIPHERAL_WIDTH_8BIT;
+#endif
+    dma_init_struct.priority = DMA_PRIORITY_LOW;
+    dma_init(SPI_DMAx, SPI_DMA_CHx, &dma_init_struct);
+
+    dma_circulation_disable(SPI_DMAx, SPI_DMA_CHx);
+    dma_memory_to_memory_disable(SPI_DMAx, SPI_DMA_CHx);
+#if defined(GD32F4XX)
+    dma_channel_subperipheral_select(SPI_DMAx, SPI_DMA_CHx, SPI_DMA_SUBPERIx);
+#endif
+
+    DMA_CHCNT(SPI_DMAx, SPI_DMA_CHx) = 0;
+
+    spi_dma_enable(SPI_PERIPH, SPI_DMA_TRANSMIT);
+}
+#endif
+
 /*
  * Public API's
  */
@@ -116,6 +160,9 @@ void Gd32SpiBegin() {
     RcuConfig();
     GpioConfig();
     SpiConfig();
+#if defined(CONFIG_SPI_ENABLE_TX_DMA)
+    DmaConfig();
+#endif
 }
 
 void Gd32SpiEnd() {
@@ -227,6 +274,47 @@ void Gd32SpiWritenb(const char* tx_buffer, uint32_t data_length) {
     SetCsHigh();
 }
 
+#if defined(CONFIG_SPI_ENABLE_TX_DMA)
+/*
+ * The chip select is not handled, the buffer must not change while active.
+ */
+void Gd32SpiDmaTxStart(const uint8_t* tx_buffer, uint32_t length) {
+    assert(tx_buffer != nullptr);
+    assert((length != 0) && (length <= 0xFFFF));
+
+    auto dma_chctl = DMA_CHCTL(SPI_DMAx, SPI_DMA_CHx);
+    dma_chctl &= ~DMA_CHXCTL_CHEN;
+    DMA_CHCTL(SPI_DMAx, SPI_DMA_CHx) = dma_chctl;
+
+    Gd32DmaInterruptFlagClear<SPI_DMAx, SPI_DMA_CHx, DMA_INTERRUPT_FLAG_CLEAR>();
+
+    DMA_CHMADDR(SPI_DMAx, SPI_DMA_CHx) = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(tx_buffer));
+    DMA_CHCNT(SPI_DMAx, SPI_DMA_CHx) = length;
+
+    dma_chctl |= DMA_CHXCTL_CHEN;
+    DMA_CHCTL(SPI_DMAx, SPI_DMA_CHx) = dma_chctl;
+}
+
+/*
+ * Active until the last byte has left the shift register.
+ * When done, the bytes received meanwhile are discarded for the blocking functions.
+ */
+bool Gd32SpiDmaTxIsActive() {
+    if (DMA_CHCNT(SPI_DMAx, SPI_DMA_CHx) != 0) {
+        return true;
+    }
+
+    if ((SPI_STAT(SPI_PERIPH) & (SPI_FLAG_TBE | SPI_FLAG_TRANS)) != SPI_FLAG_TBE) {
+        return true;
+    }
+
+    static_cast<void>(SPI_DATA(SPI_PERIPH));
+    static_cast<void>(SPI_STAT(SPI_PERIPH));
+
+    return false;
+}
+#endif
+
 #if defined(SPI_BITBANG_SCK_GPIO_PINx)
 // bitbang support
 // Note: /CS is handled by the user application
@@ -332,6 +332,12 @@ void PutChar(int c) {
 #endif
 }
 
+void Write(const char* s, uint32_t length) {
+    while (length-- != 0) {
+        PutChar(*s++);
+    }
+}
+
 void Puts(const char* s) {
     while (*s != '\0') {
         PutChar(*s++);
@@ -26,9 +26,15 @@
 //#define CONFIG_USART0_ENABLE_RX_DMA
 //#define CONFIG_USART0_ENABLE_TX_DMA
 
+#if defined(CONFIG_USART0_TX_DEFERRED) && !defined(CONFIG_USART0_ENABLE_TX_DMA)
+#error "CONFIG_USART0_TX_DEFERRED requires CONFIG_USART0_ENABLE_TX_DMA"
+#endif
+
 #include <cstdint>
 #include <cstdio>
 #include <cstdarg>
+#include <cstring>
+#include <algorithm>
 
 #include "gd32_uart.h"
 #if defined(CONFIG_USART0_ENABLE_TX_DMA) || defined(CONFIG_USART0_ENABLE_RX_DMA)
@@ -40,8 +46,146 @@ namespace uart0 {
 static char s_printf_buffer[128];
 
 #if defined(CONFIG_USART0_ENABLE_TX_DMA)
-// static char s_tx_buffer[128];
-// static constexpr uint32_t kSizeTxBuffer = sizeof(s_tx_buffer);
+#if defined(GD32F20X)
+#define USART0_TX_DMA_IRQn DMA0_Channel3_IRQn
+#define USART0_TX_DMA_IRQ_HANDLER DMA0_Channel3_IRQHandler
+#else
+#error "USART0 TX DMA is not supported"
+#endif
+
+#if !defined(CONFIG_USART0_TX_BUFFER_SIZE)
+#define CONFIG_USART0_TX_BUFFER_SIZE 2048
+#endif
+
+/*
+ * TX ring with a single producer (thread context) and a single consumer (DMA).
+ * The indices are free running. The DMA sends the contiguous part after the
+ * tail, the transfer complete interrupt advances the tail and starts the next
+ * part. A write which does not fit is dropped and counted, with
+ * CONFIG_USART0_TX_BLOCKING the producer waits for space instead.
+ * printf writes in chunks of 64 bytes, so a longer message can lose a chunk.
+ * A deferred record (CONFIG_USART0_TX_DEFERRED) is always a single write.
+ * Note: on GD32F20x, dma::memcpy32 uses the same DMA channel, gd32_dma_memcpy32.h refuses the combination.
+ */
+static constexpr uint32_t kTxBufferSize = CONFIG_USART0_TX_BUFFER_SIZE;
+static_assert((kTxBufferSize & (kTxBufferSize - 1)) == 0, "CONFIG_USART0_TX_BUFFER_SIZE must be a power of 2");
+
+static char s_tx_buffer[kTxBufferSize];
+static uint32_t s_tx_write;               ///< Producer only
+static volatile uint32_t sv_tx_head;      ///< Published by the producer
+static volatile uint32_t sv_tx_tail;      ///< Advanced by the DMA interrupt
+static volatile uint32_t sv_tx_dma_count; ///< 0 when the DMA is idle
+static uint32_t s_tx_dropped;
+
+static void TxDmaStart() {
+    const auto kTail = sv_tx_tail;
+    const auto kPending = sv_tx_head - kTail;
+
+    if (kPending == 0) {
+        sv_tx_dma_count = 0;
+        return;
+    }
+
+    const auto kOffset = kTail & (kTxBufferSize - 1);
+    const auto kCount = std::min(kPending, kTxBufferSize - kOffset);
+
+    sv_tx_dma_count = kCount;
+
+    auto dma_chctl = DMA_CHCTL(USART0_DMAx, USART0_TX_DMA_CHx);
+    dma_chctl &= ~DMA_CHXCTL_CHEN;
+    DMA_CHCTL(USART0_DMAx, USART0_TX_DMA_CHx) = dma_chctl;
+    DMA_CHMADDR(USART0_DMAx, USART0_TX_DMA_CHx) = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(&s_tx_buffer[kOffset]));
+    Gd32DmaInterruptFlagClear<USART0_DMAx, USART0_TX_DMA_CHx, DMA_INTERRUPT_FLAG_CLEAR>();
+    DMA_CHCNT(USART0_DMAx, USART0_TX_DMA_CHx) = kCount;
+    dma_chctl |= DMA_CHXCTL_CHEN;
+    DMA_CHCTL(USART0_DMAx, USART0_TX_DMA_CHx) = dma_chctl;
+}
+
+static void TxDmaComplete() {
+    Gd32DmaInterruptFlagClear<USART0_DMAx, USART0_TX_DMA_CHx, DMA_INTERRUPT_FLAG_CLEAR>();
+    sv_tx_tail = sv_tx_tail + sv_tx_dma_count;
+    TxDmaStart();
+}
+
+extern "C" void USART0_TX_DMA_IRQ_HANDLER() {
+    if (Gd32DmaInterruptFlagGet<USART0_DMAx, USART0_TX_DMA_CHx, DMA_INTERRUPT_FLAG_GET>()) {
+        TxDmaComplete();
+    }
+}
+
+// Drains the ring when the interrupt cannot run, i.e. with interrupts disabled.
+static void TxPoll() {
+    const auto kPrimask = __get_PRIMASK();
+    __disable_irq();
+
+    if (Gd32DmaInterruptFlagGet<USART0_DMAx, USART0_TX_DMA_CHx, DMA_INTERRUPT_FLAG_GET>()) {
+        TxDmaComplete();
+    }
+
+    __set_PRIMASK(kPrimask);
+}
+
+static bool TxReserve(uint32_t size) {
+    if (size > kTxBufferSize) {
+        s_tx_dropped++;
+        return false;
+    }
+
+    while ((kTxBufferSize - (s_tx_write - sv_tx_tail)) < size) {
+#if defined(CONFIG_USART0_TX_BLOCKING)
+        TxPoll();
+#else
+        s_tx_dropped++;
+        return false;
+#endif
+    }
+
+    return true;
+}
+
+static inline void TxPut(char c) {
+    s_tx_buffer[s_tx_write & (kTxBufferSize - 1)] = c;
+    s_tx_write++;
+}
+
+/*
+ * When the DMA is idle there is no interrupt pending, and when it is busy
+ * the interrupt picks up the new head. No locking is needed.
+ */
+static void TxCommit() {
+    sv_tx_head = s_tx_write;
+
+    if (sv_tx_dma_count == 0) {
+        TxDmaStart();
+    }
+}
+
+// The write is queued completely or not at all, '\n' is sent as "\r\n".
+static void TxWrite(const char* s, uint32_t length, bool newline) {
+    uint32_t size = newline ? 2 : 0;
+
+    for (uint32_t i = 0; i < length; i++) {
+        size += (s[i] == '\n') ? 2 : 1;
+    }
+
+    if (!TxReserve(size)) {
+        return;
+    }
+
+    for (uint32_t i = 0; i < length; i++) {
+        if (s[i] == '\n') {
+            TxPut('\r');
+        }
+        TxPut(s[i]);
+    }
+
+    if (newline) {
+        TxPut('\r');
+        TxPut('\n');
+    }
+
+    TxCommit();
+}
 #endif
 
 #if defined(CONFIG_USART0_ENABLE_RX_DMA)
@@ -109,8 +253,12 @@ void Init() {
 #if defined(GD32F4XX)
     dma_channel_subperipheral_select(USART0_DMAx, USART0_TX_DMA_CHx, USART0_TX_DMA_SUBPERIx);
 #endif
+    dma_interrupt_enable(USART0_DMAx, USART0_TX_DMA_CHx, DMA_INTERRUPT_ENABLE);
     // USART
     usart_dma_transmit_config(USART0, USART_TRANSMIT_DMA_ENABLE);
+    // NVIC
+    NVIC_SetPriority(USART0_TX_DMA_IRQn, 3);
+    NVIC_EnableIRQ(USART0_TX_DMA_IRQn);
 #endif // defined(CONFIG_USART0_ENABLE_TX_DMA)
 
 #if defined(CONFIG_USART0_ENABLE_RX_DMA)
@@ -156,23 +304,176 @@ void Init() {
 }
 
 #if defined(CONFIG_USART0_ENABLE_TX_DMA)
-void WriteDma(const void* data, uint32_t size) {
-    assert(data != nullptr);
-    assert(size <= DMA_CHXCNT_CNT);
+void PutChar(int c) {
+    const auto kC = static_cast<char>(c);
+    TxWrite(&kC, 1, false);
+}
 
-    while (!gd32::UartFlagGet<USART_FLAG_TBE>(USART0));
+int Printf(const char* fmt, ...) {
+    va_list arp;
 
-    auto dma_chctl = DMA_CHCTL(USART0_DMAx, USART0_TX_DMA_CHx);
-    dma_chctl &= ~DMA_CHXCTL_CHEN;
-    DMA_CHCTL(USART0_DMAx, USART0_TX_DMA_CHx) = dma_chctl;
-    DMA_CHMADDR(USART0_DMAx, USART0_TX_DMA_CHx) = reinterpret_cast<uint32_t>(data);
-    Gd32DmaInterruptFlagClear<USART0_DMAx, USART0_TX_DMA_CHx, DMA_FLAG_FTF>(); // Needed for GD32F4xx
-    DMA_CHCNT(USART0_DMAx, USART0_TX_DMA_CHx) = size;
-    dma_chctl |= DMA_CHXCTL_CHEN;
-    DMA_CHCTL(USART0_DMAx, USART0_TX_DMA_CHx) = dma_chctl;
+    va_start(arp, fmt);
+
+    int i = vsnprintf(s_printf_buffer, sizeof(s_printf_buffer), fmt, arp);
+    s_printf_buffer[sizeof(s_printf_buffer) - 1] = '\0';
+
+    va_end(arp);
+
+    TxWrite(s_printf_buffer, static_cast<uint32_t>(strlen(s_printf_buffer)), false);
+
+    return i;
+}
+
+void Write(const char* s, uint32_t length) {
+    TxWrite(s, length, false);
+}
+
+void Puts(const char* s) {
+    TxWrite(s, static_cast<uint32_t>(strlen(s)), true);
 }
+
+void Flush() {
+    while (sv_tx_dma_count != 0) {
+        TxPoll();
+    }
+
+    while (!gd32::UartFlagGet<USART_FLAG_TC>(USART0));
+}
+
+uint32_t TxDropped() {
+    return s_tx_dropped;
+}
+
+#if defined(CONFIG_USART0_TX_DEFERRED)
+/*
+ * Deferred printf, the format is expanded on the host. A record is 0x00, the
+ * payload length, the address of the format string (little endian) and the
+ * payload: a 32-bit word per argument (and per '*'), a double for %f and the
+ * characters of %s including the null. A %s longer than kDeferredStringMax is
+ * cut and ends with "...". The text output never contains 0x00.
+ * The arguments are parsed as in the printf of lib-clib.
+ * common/scripts/uart_deferred_decode.py expands the records with the format
+ * strings from the ELF file, so the format must be a string literal.
+ */
+static constexpr uint32_t kDeferredPayloadMax = 128;
+static constexpr uint32_t kDeferredStringMax = 32;
+static_assert(kDeferredPayloadMax <= UINT8_MAX);
+
+int Deferred(const char* fmt, va_list va) {
+    uint8_t payload[kDeferredPayloadMax];
+    uint32_t length = 0;
+    bool is_overflow = false;
+
+    auto put = [&](const void* data, uint32_t size) {
+        if ((length + size) > sizeof(payload)) {
+            is_overflow = true;
+            return;
+        }
+        memcpy(&payload[length], data, size);
+        length += size;
+    };
+
+    for (const auto* p = fmt; *p != '\0'; p++) {
+        if (*p != '%') {
+            continue;
+        }
+
+        p++;
+
+        if ((*p == '0') || (*p == '-')) {
+            p++;
+        }
+
+        while ((*p >= '0') && (*p <= '9')) {
+            p++;
+        }
+
+        if (*p == '.') {
+            p++;
+            if (*p == '*') {
+                p++;
+                const auto kPrecision = va_arg(va, int);
+                put(&kPrecision, 4);
+            } else {
+                while ((*p >= '0') && (*p <= '9')) {
+                    p++;
+                }
+            }
+        }
+
+        if (*p == 'l') {
+            p++;
+        }
+
+        switch (*p) {
+            case 'c':
+            case 'd':
+            case 'i':
+            case 'p':
+            case 'u':
+            case 'x':
+            case 'X': {
+                const auto kWord = va_arg(va, unsigned int);
+                put(&kWord, 4);
+                break;
+            }
+            case 's': {
+                const auto* s = va_arg(va, const char*);
+                uint32_t n = 0;
+                while ((s != nullptr) && (n < kDeferredStringMax) && (s[n] != '\0')) {
+                    n++;
+                }
+                put(s, n);
+                if ((s != nullptr) && (s[n] != '\0')) {
+                    put("...", 3);
+                }
+                put("", 1);
+                break;
+            }
+#if !defined(DISABLE_PRINTF_FLOAT)
+            case 'f': {
+                const auto kDouble = va_arg(va, double);
+                put(&kDouble, 8);
+                break;
+            }
 #endif
+            case '%':
+                break;
+            default:
+                // Not a conversion, the character is printed as text (and can start a new conversion)
+                p--;
+                break;
+        }
+    }
+
+    if (is_overflow) {
+        s_tx_dropped++;
+        return 0;
+    }
+
+    if (!TxReserve(6 + length)) {
+        return 0;
+    }
 
+    const auto kAddress = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(fmt));
+
+    TxPut('\0');
+    TxPut(static_cast<char>(length));
+    TxPut(static_cast<char>(kAddress));
+    TxPut(static_cast<char>(kAddress >> 8));
+    TxPut(static_cast<char>(kAddress >> 16));
+    TxPut(static_cast<char>(kAddress >> 24));
+
+    for (uint32_t i = 0; i < length; i++) {
+        TxPut(static_cast<char>(payload[i]));
+    }
+
+    TxCommit();
+
+    return static_cast<int>(6 + length);
+}
+#endif
+#else
 void PutChar(int c) {
     if (c == '\n') {
         while (!gd32::UartFlagGet<USART_FLAG_TBE>(USART0));
@@ -202,6 +503,12 @@ int Printf(const char* fmt, ...) {
     return i;
 }
 
+void Write(const char* s, uint32_t length) {
+    while (length-- != 0) {
+        PutChar(*s++);
+    }
+}
+
 void Puts(const char* s) {
     while (*s != '\0') {
         PutChar(*s++);
@@ -209,6 +516,7 @@ void Puts(const char* s) {
 
     PutChar('\n');
 }
+#endif
 
 #if defined(CONFIG_USART0_ENABLE_RX_DMA)
 int GetChar() {
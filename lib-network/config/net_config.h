@@ -49,6 +49,18 @@
  * Supports checking IPv4 header checksum and TCP, UDP, or ICMP checksum encapsulated in IPv4 or IPv6 datagram.
  */
 #  define CHECKSUM_BY_HARDWARE
+/*
+ * Multicast is filtered by the MAC (perfect and hash filter), maintained from the IGMP group table.
+ */
+#  if !defined(DISABLE_EMAC_HASH_MULTICAST_FILTER) && !defined(CONFIG_EMAC_HASH_MULTICAST_FILTER)
+#   define CONFIG_EMAC_HASH_MULTICAST_FILTER
+#  endif
+/*
+ * Per-protocol and drop counters and the RX latency histogram, see network_stats.h
+ */
+#  if !defined(DISABLE_NET_STATS) && !defined(CONFIG_REMOTECONFIG_MINIMUM) && !defined(CONFIG_NET_ENABLE_STATS)
+#   define CONFIG_NET_ENABLE_STATS
+#  endif
 #  if !defined(HOST_NAME_PREFIX)
 #   define HOST_NAME_PREFIX				"gigadevice-"
 #  endif
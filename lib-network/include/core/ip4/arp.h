@@ -35,6 +35,7 @@ enum class Flags { kFlagInsert, kFlagUpdate };
 void Init();
 void Input(const struct network::arp::Header*);
 void Send(void*, const uint32_t, uint32_t);
+void SendQueue(void*, uint32_t, uint32_t);
 #if defined CONFIG_NET_ENABLE_PTP
 void SendTimestamp(void*, uint32_t, uint32_t);
 #endif
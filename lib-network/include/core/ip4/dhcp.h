@@ -38,6 +38,8 @@ static constexpr uint32_t kCoarseTimerSecs = 60;
 static constexpr uint32_t kCoarseTimerMsecs = (kCoarseTimerSecs * 1000UL);
 // period (in milliseconds) of the application calling dhcp_fine_tmr()
 static constexpr uint32_t kFineTimerMsecs = 500;
+// Spreads the first message of nodes which are powered on at the same time
+static constexpr uint32_t kStartDelayMaxMsecs = 1000;
 
 static constexpr uint8_t kFlagSubnetMaskGiven = 0x01;
 
@@ -75,7 +77,14 @@ struct Dhcp {
     acd::Acd acd;
 };
 
-bool Start();
+/**
+ * @brief Starts the DHCP client after a random delay of up to kStartDelayMaxMsecs.
+ *
+ * @param requested_ip The address of the previous lease. When not 0 it is
+ *        requested first with INIT-REBOOT (RFC 2131, 4.3.2), the client falls
+ *        back to DISCOVER when the server does not answer.
+ */
+bool Start(uint32_t requested_ip = 0);
 bool Renew();
 bool Release();
 void Stop();
@@ -29,10 +29,10 @@
 #include <cstdint>
 
 namespace emac::multicast {
-void EnableHashFilter();
-void DisableHashFilter();
-void SetHash(const uint8_t*);
-void ResetHash();
+void Enable();
+void Disable();
+void Add(const uint8_t*);
+void Reset();
 } // namespace emac::multicast
 
 #endif // CORE_IP4_IGMP_H_
@@ -30,16 +30,31 @@
 
 namespace network::acd {
 //  RFC 5227 and RFC 3927 Constants
-inline constexpr uint32_t kProbeWait = 1;          ///< second  (initial random delay)
-inline constexpr uint32_t kProbeMin = 1;           ///< second  (minimum delay till repeated probe)
-inline constexpr uint32_t kProbeMax = 2;           ///< seconds (maximum delay till repeated probe)
-inline constexpr uint32_t kProbeNum = 3;           ///<         (number of probe packets)
-inline constexpr uint32_t kAnnounceNum = 2;        ///<         (number of announcement packets)
-inline constexpr uint32_t kAnnounceInterval = 2;   ///< seconds (time between announcement packets)
-inline constexpr uint32_t kAnnounceWait = 2;       ///< seconds (delay before announcing)
-inline constexpr uint32_t kMaxConflicts = 10;      ///<         (max conflicts before rate limiting)
-inline constexpr uint32_t kRateLimitInterval = 60; ///< seconds (delay between successive attempts)
-inline constexpr uint32_t kDefendInterval = 10;    ///< seconds (minimum interval between defensive ARPs)
+#if defined(CONFIG_NET_ACD_FAST)
+/*
+ * Fast profile for a switched LAN. The probe window is shortened to well below
+ * a second and the address is used while probing (passive), the node backs off
+ * on an actual conflict only.
+ */
+inline constexpr uint32_t kProbeWait = 100;            ///< milliseconds (initial random delay)
+inline constexpr uint32_t kProbeMin = 100;             ///< milliseconds (minimum delay till repeated probe)
+inline constexpr uint32_t kProbeMax = 200;             ///< milliseconds (maximum delay till repeated probe)
+inline constexpr uint32_t kProbeNum = 2;               ///<              (number of probe packets)
+inline constexpr uint32_t kAnnounceNum = 2;            ///<              (number of announcement packets)
+inline constexpr uint32_t kAnnounceInterval = 1000;    ///< milliseconds (time between announcement packets)
+inline constexpr uint32_t kAnnounceWait = 200;         ///< milliseconds (delay before announcing)
+#else
+inline constexpr uint32_t kProbeWait = 1000;           ///< milliseconds (initial random delay)
+inline constexpr uint32_t kProbeMin = 1000;            ///< milliseconds (minimum delay till repeated probe)
+inline constexpr uint32_t kProbeMax = 2000;            ///< milliseconds (maximum delay till repeated probe)
+inline constexpr uint32_t kProbeNum = 3;               ///<              (number of probe packets)
+inline constexpr uint32_t kAnnounceNum = 2;            ///<              (number of announcement packets)
+inline constexpr uint32_t kAnnounceInterval = 2000;    ///< milliseconds (time between announcement packets)
+inline constexpr uint32_t kAnnounceWait = 2000;        ///< milliseconds (delay before announcing)
+#endif
+inline constexpr uint32_t kMaxConflicts = 10;          ///<              (max conflicts before rate limiting)
+inline constexpr uint32_t kRateLimitInterval = 60000;  ///< milliseconds (delay between successive attempts)
+inline constexpr uint32_t kDefendInterval = 10000;     ///< milliseconds (minimum interval between defensive ARPs)
 
 enum class State : uint8_t { kAcdStateOff, kAcdStateProbeWait, kAcdStateProbing, kAcdStateAnnounceWait, kAcdStateAnnouncing, kAcdStateOngoing, kAcdStatePassiveOngoing, kAcdStateRateLimit };
 
@@ -40,6 +40,9 @@ namespace emac {
  */
 void Config();
 
+/**
+ * Set the MAC speed and duplex, called when the link comes up
+ */
 void AdjustLink(emac::phy::Status phy_status);
 
 /**
@@ -47,8 +50,8 @@ void AdjustLink(emac::phy::Status phy_status);
  * - Soft MAC reset
  * - Set the MAC address
  * - Initialize rx/tx descriptors
- * - PHY Start Up -> \ref emac::phy::Start
- * - Adjust the link with duplex and speed returned from \ref emac::phy::Start
+ * - PHY Start Up -> \ref emac::phy::Start, does not wait for auto-negotiation
+ * - Start the link state machine -> \ref emac::link::Start
  * - Start RX/TX DMA
  * - Enable RX/TX
  *
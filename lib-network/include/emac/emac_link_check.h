@@ -29,6 +29,16 @@
 #include "emac_phy.h"
 
 namespace emac::link {
+/**
+ * Link bring-up state machine, called from \ref emac::Start
+ * @param link Link state returned by \ref emac::phy::Start
+ */
+void Start(emac::phy::Link link);
+/**
+ * Advances the state machine, called from network::Run()
+ * Polls for auto-negotiation completion and handles link changes.
+ */
+void Run();
 emac::phy::Link StatusRead();
 void HandleChange(emac::phy::Link state);
 // Platform defined implementations
@@ -40,6 +50,7 @@ void PinRecovery();
 // #if defined(ENET_LINK_CHECK_USE_INT)
 void ExtiInit();
 void InterruptInit();
+void InterruptPoll();
 // #elif defined(ENET_LINK_CHECK_USE_PIN_POLL)
 void PinPollInit();
 void PinPoll();
@@ -61,13 +61,25 @@ Link GetLink(uint16_t address);
 bool Powerdown(uint16_t address);
 
 /**
- *
- * Called from \ref Start
+ * Configures auto-negotiation, does not wait for it to complete.
+ * Auto-negotiation is only restarted when the advertisement changed.
+ * Called from \ref emac::Start
  *
  * @param address PHY address
+ * @param[out] phy_status Link is up when auto-negotiation has already completed
  * @return true for success, false for failure
  */
 bool Start(uint16_t address, Status& phy_status);
+
+/**
+ * Non-blocking read of the link, speed and duplex.
+ * The link is reported down until auto-negotiation has completed.
+ *
+ * @param address PHY address
+ * @param[out] phy_status
+ * @return true for success, false for failure
+ */
+bool GetStatus(uint16_t address, Status& phy_status);
 /** @} */
 
 /** \defgroup platform Platform implementation
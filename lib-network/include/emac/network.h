@@ -40,9 +40,7 @@
 #if defined(ENABLE_HTTPD)
 #include "network_tcp.h" // IWYU pragma: keep
 #endif
-#if defined(ENET_LINK_CHECK_USE_PIN_POLL) || defined(ENET_LINK_CHECK_REG_POLL)
 #include "emac/emac_link_check.h"
-#endif
 #include "emac/emac_phy.h"
 
 uint32_t emac::eth::Recv(uint8_t**);
@@ -75,15 +73,7 @@ inline void Run() {
 #if defined(CONFIG_NET_ENABLE_PTP)
     network::ptp::Run();
 #endif
-#if defined(ENET_LINK_CHECK_USE_PIN_POLL)
-    emac::link::PinPoll();
-#elif defined(ENET_LINK_CHECK_REG_POLL)
-    const emac::phy::Link link_state = emac::link::StatusRead();
-    if (link_state != global::link_state) {
-        global::link_state = link_state;
-        emac::link::HandleChange(link_state);
-    }
-#endif
+    emac::link::Run();
 }
 } // namespace network
 
@@ -0,0 +1,144 @@
+/**
+ * @file network_stats.h
+ *
+ */
+/* Copyright (C) 2026 by Arjan van Vught mailto:info@gd32-dmx.org
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef NETWORK_STATS_H_
+#define NETWORK_STATS_H_
+
+#include <cstdint>
+
+#include "net_config.h"
+#if defined(CONFIG_NET_ENABLE_STATS)
+#include "core/protocol/ieee.h"
+#include "core/protocol/ip4.h"
+#include "timing.h"
+#endif
+
+/*
+ * Per-protocol and per-stage counters, together with network::iface::GetCounters
+ * (MAC level) they show where a frame was lost: MAC, pool or application.
+ * The recording functions compile to nothing without CONFIG_NET_ENABLE_STATS.
+ */
+namespace network::stats {
+enum class Protocol : uint8_t { kArp, kIcmp, kIgmp, kUdp, kTcp, kOther, kCount };
+
+enum class Drop : uint8_t {
+    kNoPort,    ///< UDP datagram for a port without a listener
+    kChecksum,  ///< Flagged by the MAC checksum engine
+    kPoolFull,  ///< network::memory pool exhausted
+    kMulticast, ///< Multicast group not joined
+    kCount
+};
+
+inline constexpr uint32_t kProtocols = static_cast<uint32_t>(Protocol::kCount);
+inline constexpr uint32_t kDrops = static_cast<uint32_t>(Drop::kCount);
+/// Bucket n counts latencies below 2^n microseconds, the last bucket the remaining ones.
+inline constexpr uint32_t kLatencyBuckets = 12;
+
+struct Stats {
+    uint32_t rx[kProtocols];
+    uint32_t tx[kProtocols];
+    uint32_t drop[kDrops];
+    uint32_t tx_wait_cycles;           ///< CPU cycles spent waiting for a TX descriptor owned by the DMA
+    uint32_t latency[kLatencyBuckets]; ///< From the frame leaving the RX DMA ring to the UDP callback
+};
+
+#if defined(CONFIG_NET_ENABLE_STATS)
+namespace global {
+extern Stats stats;
+extern uint32_t rx_micros;
+} // namespace global
+
+inline Protocol Classify(const uint8_t* frame) {
+    const auto* const kIp4 = reinterpret_cast<const struct network::ip4::Header*>(frame);
+
+    if (kIp4->ether.type == __builtin_bswap16(network::ethernet::Type::kArp)) {
+        return Protocol::kArp;
+    }
+
+    if (kIp4->ether.type != __builtin_bswap16(network::ethernet::Type::kIPv4)) {
+        return Protocol::kOther;
+    }
+
+    switch (kIp4->ip4.proto) {
+        case network::ip4::Proto::kUdp:
+            return Protocol::kUdp;
+        case network::ip4::Proto::kIcmp:
+            return Protocol::kIcmp;
+        case network::ip4::Proto::kIgmp:
+            return Protocol::kIgmp;
+        case network::ip4::Proto::kTcp:
+            return Protocol::kTcp;
+        default:
+            return Protocol::kOther;
+    }
+}
+#endif
+
+inline void Receive([[maybe_unused]] const uint8_t* frame) {
+#if defined(CONFIG_NET_ENABLE_STATS)
+    global::rx_micros = timing::Micros();
+    global::stats.rx[static_cast<uint32_t>(Classify(frame))]++;
+#endif
+}
+
+inline void Transmit([[maybe_unused]] const uint8_t* frame) {
+#if defined(CONFIG_NET_ENABLE_STATS)
+    global::stats.tx[static_cast<uint32_t>(Classify(frame))]++;
+#endif
+}
+
+inline void Dropped([[maybe_unused]] Drop drop) {
+#if defined(CONFIG_NET_ENABLE_STATS)
+    global::stats.drop[static_cast<uint32_t>(drop)]++;
+#endif
+}
+
+inline void TxWait([[maybe_unused]] uint32_t cycles) {
+#if defined(CONFIG_NET_ENABLE_STATS)
+    global::stats.tx_wait_cycles += cycles;
+#endif
+}
+
+/**
+ * @brief Records the latency of the frame passed to the last Receive().
+ */
+inline void Delivered() {
+#if defined(CONFIG_NET_ENABLE_STATS)
+    const auto kMicros = timing::Micros() - global::rx_micros;
+    const auto kBucket = (kMicros == 0) ? 0U : static_cast<uint32_t>(32 - __builtin_clz(kMicros));
+    global::stats.latency[(kBucket < kLatencyBuckets) ? kBucket : (kLatencyBuckets - 1)]++;
+#endif
+}
+
+void Reset();
+/**
+ * @brief Text report, MAC counters, per-protocol counters, drops and the latency histogram.
+ * @return The number of characters written, excluding the terminating null.
+ */
+uint32_t Format(char* buffer, uint32_t size);
+void Print();
+} // namespace network::stats
+
+#endif // NETWORK_STATS_H_
@@ -34,6 +34,7 @@ void SaveNetmask(uint32_t net_mask);
 void SaveGatewayIp(uint32_t gateway_ip);
 void SaveHostname(const char* hostname, uint32_t length);
 void SaveDhcp(bool is_dhcp_used);
+void SaveDhcpLease(uint32_t ip);
 } // namespace network::store
 
 #endif // NETWORK_STORE_H_
@@ -25,6 +25,7 @@
 #include <cstdint>
 #include <cstring>
 #include <cstdio>
+#include <cstdlib> // IWYU pragma: keep // Needed for random())
 #include <algorithm>
 #include <cassert>
 
@@ -36,6 +37,8 @@
 #include "core/protocol/ip4.h"
 #include "core/protocol/dns.h"
 #include "core/protocol/iana.h"
+#include "softwaretimers.h"
+#include "timing.h"
 #include "firmware/debug/debug_debug.h"
 
 #if defined(DEBUG_NETWORK_APPS_MDNS)
@@ -200,6 +203,75 @@ static uint16_t s_n_remote_port;
 static bool s_is_unicast;
 static bool s_is_legacy_query;
 
+/*
+ * Response cache. The answer sets are serialized once, when a record is added
+ * and when the host name or the IP address changes (SendAnnouncement).
+ * A query is answered with the prebuilt message, only the transaction ID is patched.
+ */
+struct Cache {
+    uint8_t* message;
+    uint16_t length;
+};
+
+struct RecordCache {
+    Cache enumeration; ///< _services._dns-sd._udp.local PTR
+    Cache service;     ///< PTR, SRV, TXT and the A record as additional
+};
+
+static RecordCache s_record_caches[kServiceRecordsMax];
+static Cache s_host_cache; ///< A
+
+static void CacheFree(Cache& cache) {
+    delete[] cache.message;
+    cache.message = nullptr;
+    cache.length = 0;
+}
+
+/*
+ * RFC 6762, 6. Responding
+ * Multicast responses are delayed 20-120 ms, the answers of all queries received
+ * in the meantime are aggregated into one message. A record is not multicast
+ * again within one second.
+ */
+static constexpr uint32_t kResponseDelayMin = 20;    ///< (in milliseconds)
+static constexpr uint32_t kResponseDelayMax = 120;   ///< (in milliseconds)
+static constexpr uint32_t kMulticastInterval = 1000; ///< (in milliseconds)
+
+/*
+ * RFC 6762, 7.2. Multipacket Known-Answer Suppression
+ * A query with the TC bit is followed by more Known-Answer packets. The
+ * response is delayed 400-500 ms and the known answers of the follow-up
+ * packets from the same querier are taken off the pending response.
+ */
+static constexpr uint32_t kTruncatedDelayMin = 400; ///< (in milliseconds)
+static constexpr uint32_t kTruncatedDelayMax = 500; ///< (in milliseconds)
+
+struct LastMulticast {
+    uint32_t enumeration;
+    uint32_t service;
+};
+
+static uint32_t s_pending_host_replies;
+static uint32_t s_pending_service_replies[kServiceRecordsMax];
+static LastMulticast s_record_last_multicast[kServiceRecordsMax];
+static uint32_t s_host_last_multicast;
+static TimerHandle_t s_timer_id = kTimerIdNone;
+static uint32_t s_truncated_from_ip; ///< Querier of a TC query, its known answers follow
+
+static bool IsRecentlyMulticast(uint32_t last_multicast) {
+    return (timing::Millis() - last_multicast) < kMulticastInterval;
+}
+
+static void TimerStop() {
+    if (s_timer_id != kTimerIdNone) {
+        SoftwareTimerDelete(s_timer_id);
+    }
+
+    s_pending_host_replies = 0;
+    memset(s_pending_service_replies, 0, sizeof(s_pending_service_replies));
+    s_truncated_from_ip = 0;
+}
+
 static void CreateServiceDomain(mdns::Domain& domain, ServiceRecord const& service_record, bool include_name) {
     MDNS_DEBUG_ENTRY();
 
@@ -623,13 +695,26 @@ void Start() {
 void Stop() {
     MDNS_DEBUG_ENTRY();
 
+    TimerStop();
     mdns::SendAnnouncement(0);
 
     for (auto& record : s_service_records) {
         delete[] record.name;
         delete[] record.text_content;
+
+        record.name = nullptr;
+        record.text_content = nullptr;
+        record.text_content_length = 0;
+        record.services = Services::kLastNotUsed;
+    }
+
+    for (auto& cache : s_record_caches) {
+        CacheFree(cache.enumeration);
+        CacheFree(cache.service);
     }
 
+    CacheFree(s_host_cache);
+
     network::igmp::LeaveGroup(s_handle, network::dns::kMulticastAddress);
     network::udp::End(network::iana::Ports::kPortMdns);
     s_handle = -1;
@@ -637,13 +722,17 @@ void Stop() {
     MDNS_DEBUG_EXIT();
 }
 
-static void Send(uint32_t length) {
+static void Send(const uint8_t* message, uint32_t length) {
     if (!s_is_unicast) {
-        network::udp::Send(s_handle, s_records_data, length, network::dns::kMulticastAddress, network::iana::Ports::kPortMdns);
+        network::udp::Send(s_handle, message, length, network::dns::kMulticastAddress, network::iana::Ports::kPortMdns);
         return;
     }
 
-    network::udp::Send(s_handle, s_records_data, length, s_n_remote_ip, s_n_remote_port);
+    network::udp::Send(s_handle, message, length, s_n_remote_ip, s_n_remote_port);
+}
+
+static void Send(uint32_t length) {
+    Send(s_records_data, length);
 }
 
 static void SendAnswerLocalIpAddress(uint16_t trans_action_id, uint32_t ttl) {
@@ -737,18 +826,248 @@ static void SendMessage(mdns::ServiceRecord const& record, uint16_t transaction_
     MDNS_DEBUG_EXIT();
 }
 
+// Completes the response in s_records_data, returns the message length
+static uint16_t SetHeader(const uint8_t* end, uint32_t answers, uint32_t additionals) {
+    auto* header = reinterpret_cast<network::dns::Header*>(&s_records_data);
+
+    header->xid = 0;
+    header->flag1 = network::dns::Flag1::kResponse | network::dns::Flag1::kAuthorative;
+    header->flag2 = 0;
+    header->query_count = 0;
+    header->answer_count = __builtin_bswap16(static_cast<uint16_t>(answers));
+    header->authority_count = 0;
+    header->additional_count = __builtin_bswap16(static_cast<uint16_t>(additionals));
+
+    return static_cast<uint16_t>(end - reinterpret_cast<uint8_t*>(header));
+}
+
+static void CacheStore(Cache& cache, const uint8_t* end, uint32_t answers, uint32_t additionals) {
+    const auto kLength = SetHeader(end, answers, additionals);
+
+    if (kLength != cache.length) {
+        CacheFree(cache);
+        cache.message = new uint8_t[kLength];
+        assert(cache.message != nullptr);
+        cache.length = kLength;
+    }
+
+    memcpy(cache.message, s_records_data, kLength);
+}
+
+// The messages are serialized in s_records_data, the compression pointers are relative to its start.
+static void CacheBuild(uint32_t index) {
+    MDNS_DEBUG_ENTRY();
+
+    const auto& record = s_service_records[index];
+    auto& cache = s_record_caches[index];
+    auto* const kBody = reinterpret_cast<uint8_t*>(&s_records_data) + sizeof(struct network::dns::Header);
+
+    auto* dst = kBody;
+    dst += AddAnswerDnsdPtr(record, dst, kMdnsResponseTtl);
+    CacheStore(cache.enumeration, dst, 1, 0);
+
+    dst = kBody;
+    dst += AddAnswerPtr(record, dst, kMdnsResponseTtl);
+    dst += AddAnswerSrv(record, dst, kMdnsResponseTtl);
+    dst += AddAnswerTxt(record, dst, kMdnsResponseTtl);
+    dst += AddAnswerA(dst, kMdnsResponseTtl);
+    CacheStore(cache.service, dst, 3, 1);
+
+    MDNS_DEBUG_EXIT();
+}
+
+static void CacheBuildAll() {
+    auto* dst = reinterpret_cast<uint8_t*>(&s_records_data) + sizeof(struct network::dns::Header);
+    dst += AddAnswerA(dst, kMdnsResponseTtl);
+    CacheStore(s_host_cache, dst, 1, 0);
+
+    for (uint32_t index = 0; index < static_cast<uint32_t>(kServiceRecordsMax); index++) {
+        if (s_service_records[index].services < Services::kLastNotUsed) {
+            CacheBuild(index);
+        }
+    }
+}
+
+static void SendCached(Cache& cache, uint16_t transaction_id) {
+    if (cache.message == nullptr) {
+        return;
+    }
+
+    reinterpret_cast<network::dns::Header*>(cache.message)->xid = transaction_id;
+    Send(cache.message, cache.length);
+}
+
+static uint32_t CacheBodyLength(const Cache& cache) {
+    if (cache.length == 0) {
+        return 0;
+    }
+
+    return static_cast<uint32_t>(cache.length - sizeof(struct network::dns::Header));
+}
+
+/*
+ * Sends the aggregated multicast response. A single answer set goes out
+ * prebuilt, otherwise the answers are serialized into one message. The cached
+ * message length is the upper bound of an answer set, when the next one might
+ * not fit the message is sent and a new one is started.
+ */
+static void SendPending() {
+    MDNS_DEBUG_ENTRY();
+
+    s_is_unicast = false;
+    s_is_legacy_query = false;
+
+    const auto kNow = timing::Millis();
+    uint32_t sets = 0;
+    Cache* single = nullptr;
+
+    for (uint32_t index = 0; index < static_cast<uint32_t>(kServiceRecordsMax); index++) {
+        const auto kReplies = s_pending_service_replies[index];
+
+        if ((kReplies & ServiceReply::kTypePtr) == ServiceReply::kTypePtr) {
+            sets++;
+            single = &s_record_caches[index].enumeration;
+            s_record_last_multicast[index].enumeration = kNow;
+        }
+
+        if ((kReplies & (ServiceReply::kNamePtr | ServiceReply::kSrv | ServiceReply::kTxt)) != 0) {
+            sets++;
+            single = &s_record_caches[index].service;
+            s_record_last_multicast[index].service = kNow;
+        }
+    }
+
+    const auto kHostA = ((s_pending_host_replies & HostReply::kA) == HostReply::kA);
+
+    if (kHostA) {
+        sets++;
+        single = &s_host_cache;
+        s_host_last_multicast = kNow;
+    }
+
+#if defined(CONFIG_MDNS_DOMAIN_REVERSE)
+    if ((s_pending_host_replies & HostReply::kPtr) == HostReply::kPtr) {
+        s_host_replies = HostReply::kPtr;
+        SendAnswerLocalIpAddress(0, kMdnsResponseTtl);
+    }
+#endif
+
+    if (sets == 1) {
+        SendCached(*single, 0);
+    } else if (sets > 1) {
+        auto* const kBody = reinterpret_cast<uint8_t*>(&s_records_data) + sizeof(struct network::dns::Header);
+        const auto kHostLength = CacheBodyLength(s_host_cache);
+        auto* dst = kBody;
+        uint32_t answers = 0;
+
+        if (kHostA) {
+            answers++;
+            dst += AddAnswerA(dst, kMdnsResponseTtl);
+        }
+
+        for (uint32_t index = 0; index < static_cast<uint32_t>(kServiceRecordsMax); index++) {
+            const auto kReplies = s_pending_service_replies[index];
+
+            if (kReplies == 0) {
+                continue;
+            }
+
+            const auto& record = s_service_records[index];
+            const auto& cache = s_record_caches[index];
+            const auto kIsEnumeration = ((kReplies & ServiceReply::kTypePtr) == ServiceReply::kTypePtr);
+            const auto kIsService = ((kReplies & (ServiceReply::kNamePtr | ServiceReply::kSrv | ServiceReply::kTxt)) != 0);
+            const auto kLength = (kIsEnumeration ? CacheBodyLength(cache.enumeration) : 0) + (kIsService ? CacheBodyLength(cache.service) : 0);
+
+            if ((answers != 0) && (static_cast<uint32_t>(dst - s_records_data) + kLength + kHostLength > sizeof(s_records_data))) {
+                if (!kHostA) {
+                    dst += AddAnswerA(dst, kMdnsResponseTtl);
+                }
+                Send(SetHeader(dst, answers, kHostA ? 0 : 1));
+
+                dst = kBody;
+                answers = 0;
+
+                if (kHostA) {
+                    answers++;
+                    dst += AddAnswerA(dst, kMdnsResponseTtl);
+                }
+            }
+
+            if (kIsEnumeration) {
+                answers++;
+                dst += AddAnswerDnsdPtr(record, dst, kMdnsResponseTtl);
+            }
+
+            if (kIsService) {
+                answers += 3;
+                dst += AddAnswerPtr(record, dst, kMdnsResponseTtl);
+                dst += AddAnswerSrv(record, dst, kMdnsResponseTtl);
+                dst += AddAnswerTxt(record, dst, kMdnsResponseTtl);
+            }
+        }
+
+        if (!kHostA) {
+            dst += AddAnswerA(dst, kMdnsResponseTtl);
+        }
+        Send(SetHeader(dst, answers, kHostA ? 0 : 1));
+    }
+
+    s_pending_host_replies = 0;
+    memset(s_pending_service_replies, 0, sizeof(s_pending_service_replies));
+    s_truncated_from_ip = 0;
+
+    MDNS_DEBUG_EXIT();
+}
+
+static void Timer([[maybe_unused]] TimerHandle_t handle) {
+    SoftwareTimerDelete(s_timer_id);
+    SendPending();
+}
+
+static void TimerStart(uint32_t delay) {
+    if (s_timer_id != kTimerIdNone) {
+        SoftwareTimerDelete(s_timer_id);
+    }
+
+    s_timer_id = SoftwareTimerAdd(delay, Timer);
+    MDNS_DEBUG_PRINTF("s_timer_id=%d, delay=%u", static_cast<int>(s_timer_id), static_cast<unsigned>(delay));
+
+    if (s_timer_id == kTimerIdNone) {
+        SendPending();
+    }
+}
+
+static uint32_t TruncatedDelay() {
+    return kTruncatedDelayMin + static_cast<uint32_t>(random()) % (1 + kTruncatedDelayMax - kTruncatedDelayMin);
+}
+
+static void StampRecords(uint32_t index) {
+    const auto kNow = timing::Millis();
+    s_record_last_multicast[index].enumeration = kNow;
+    s_record_last_multicast[index].service = kNow;
+}
+
 void SendAnnouncement(uint32_t ttl) {
     MDNS_DEBUG_ENTRY();
 
-    s_n_remote_port = network::iana::Ports::kPortMdns; // FIXME Hack ;-)
+    if (ttl != 0) {
+        CacheBuildAll();
+    }
+
+    s_is_unicast = false;
+    s_is_legacy_query = false;
     s_host_replies = HostReply::kA;
+    s_host_last_multicast = timing::Millis();
 
     SendAnswerLocalIpAddress(0, ttl);
 
-    for (auto& record : s_service_records) {
+    for (uint32_t index = 0; index < static_cast<uint32_t>(kServiceRecordsMax); index++) {
+        const auto& record = s_service_records[index];
+
         if (record.services < Services::kLastNotUsed) {
             s_service_replies = ServiceReply::kTypePtr | ServiceReply::kNamePtr | ServiceReply::kSrv | ServiceReply::kTxt;
             SendMessage(record, 0, ttl);
+            StampRecords(index);
         }
     }
 
@@ -759,7 +1078,9 @@ bool ServiceRecordAdd(const char* name, mdns::Services services, const char* tex
     MDNS_DEBUG_ENTRY();
     assert(services < mdns::Services::kLastNotUsed);
 
-    for (auto& record : s_service_records) {
+    for (uint32_t index = 0; index < static_cast<uint32_t>(kServiceRecordsMax); index++) {
+        auto& record = s_service_records[index];
+
         if (record.services == Services::kLastNotUsed) {
             if (name != nullptr) {
                 const auto kLength = std::min(kLabelMaxlen, strlen(name));
@@ -793,11 +1114,13 @@ bool ServiceRecordAdd(const char* name, mdns::Services services, const char* tex
                 record.text_content_length = static_cast<uint16_t>(kLength);
             }
 
-            s_n_remote_port = network::iana::Ports::kPortMdns; // FIXME Hack ;-)
+            CacheBuild(index);
 
+            s_is_unicast = false;
             s_service_replies = ServiceReply::kTypePtr | ServiceReply::kNamePtr | ServiceReply::kSrv | ServiceReply::kTxt;
 
             SendMessage(record, 0, kMdnsResponseTtl);
+            StampRecords(index);
 
             Domain domain;
             CreateServiceDomain(domain, record, false);
@@ -816,17 +1139,26 @@ bool ServiceRecordDelete(mdns::Services service) {
     MDNS_DEBUG_ENTRY();
     assert(service < mdns::Services::kLastNotUsed);
 
-    for (auto& record : s_service_records) {
+    for (uint32_t index = 0; index < static_cast<uint32_t>(kServiceRecordsMax); index++) {
+        auto& record = s_service_records[index];
+
         if (record.services == service) {
+            s_is_unicast = false;
+            s_service_replies = ServiceReply::kTypePtr | ServiceReply::kNamePtr | ServiceReply::kSrv | ServiceReply::kTxt;
             SendMessage(record, 0, 0);
 
-            if (record.name != nullptr) {
-                delete[] record.name;
-            }
+            s_pending_service_replies[index] = 0;
 
-            if (record.text_content != nullptr) {
-                delete[] record.text_content;
-            }
+            delete[] record.name;
+            delete[] record.text_content;
+
+            record.name = nullptr;
+            record.text_content = nullptr;
+            record.text_content_length = 0;
+            record.services = Services::kLastNotUsed;
+
+            CacheFree(s_record_caches[index].enumeration);
+            CacheFree(s_record_caches[index].service);
 
             MDNS_DEBUG_EXIT();
             return true;
@@ -837,9 +1169,186 @@ bool ServiceRecordDelete(mdns::Services service) {
     return false;
 }
 
-static void HandleQuestions(uint32_t questions) {
+// The length of the (uncompressed) domain name as returned by GetDomainName
+static uint16_t DomainLength(const uint8_t* name) {
+    const auto* p = name;
+
+    while (*p != 0) {
+        p += 1 + *p;
+    }
+
+    return static_cast<uint16_t>(1 + p - name);
+}
+
+static const uint8_t* GetDomain(uint32_t& offset, Domain& domain) {
+    const auto* result = GetDomainName(s_p_receive_buffer, &s_p_receive_buffer[offset], &s_p_receive_buffer[s_n_bytes_received], domain.a_name);
+
+    if (result != nullptr) {
+        domain.length = DomainLength(domain.a_name);
+        offset = static_cast<uint32_t>(result - s_p_receive_buffer);
+    }
+
+    return result;
+}
+
+/*
+ * RFC 6762, 7.1. Known-Answer Suppression
+ * A record in the Answer Section of the query, with at least half of our TTL,
+ * is not sent again. Only the PTR and A records are checked.
+ */
+static void HandleKnownAnswers(uint32_t offset, uint32_t answers, uint32_t* service_replies, uint32_t& host_replies) {
     MDNS_DEBUG_ENTRY();
-    MDNS_DEBUG_PRINTF("questions=%u", static_cast<unsigned>(questions));
+
+    for (uint32_t i = 0; i < answers; i++) {
+        Domain answer_domain;
+
+        if (GetDomain(offset, answer_domain) == nullptr) {
+            break;
+        }
+
+        if (offset + 10 > s_n_bytes_received) {
+            break;
+        }
+
+        const auto kType = static_cast<network::dns::RRType>(__builtin_bswap16(*reinterpret_cast<uint16_t*>(&s_p_receive_buffer[offset])));
+        const auto kTtl = __builtin_bswap32(*reinterpret_cast<uint32_t*>(&s_p_receive_buffer[offset + 4]));
+        const auto kDataLength = __builtin_bswap16(*reinterpret_cast<uint16_t*>(&s_p_receive_buffer[offset + 8]));
+        offset += 10;
+
+        const auto kDataOffset = offset;
+        offset += kDataLength;
+
+        if ((offset > s_n_bytes_received) || (kTtl < (kMdnsResponseTtl / 2))) {
+            continue;
+        }
+
+        if (kType == network::dns::RRType::kA) {
+            if ((kDataLength == 4) && (*reinterpret_cast<uint32_t*>(&s_p_receive_buffer[kDataOffset]) == network::GetPrimaryIp())) {
+                Domain domain;
+                CreateHostDomain(domain);
+
+                if (domain == answer_domain) {
+                    host_replies &= ~HostReply::kA;
+                }
+            }
+            continue;
+        }
+
+        if (kType != network::dns::RRType::kPtr) {
+            continue;
+        }
+
+        Domain target_domain;
+        auto target_offset = kDataOffset;
+
+        if (GetDomain(target_offset, target_domain) == nullptr) {
+            continue;
+        }
+
+        const auto kIsEnumeration = (kDomainDnssd == answer_domain);
+
+        for (uint32_t index = 0; index < static_cast<uint32_t>(kServiceRecordsMax); index++) {
+            const auto& record = s_service_records[index];
+
+            if (record.services == Services::kLastNotUsed) {
+                continue;
+            }
+
+            Domain domain;
+            CreateServiceDomain(domain, record, false);
+
+            if (kIsEnumeration) {
+                if (domain == target_domain) {
+                    service_replies[index] &= ~ServiceReply::kTypePtr;
+                }
+                continue;
+            }
+
+            if (domain == answer_domain) {
+                CreateServiceDomain(domain, record, true);
+
+                if (domain == target_domain) {
+                    service_replies[index] &= ~ServiceReply::kNamePtr;
+                }
+            }
+        }
+    }
+
+    MDNS_DEBUG_EXIT();
+}
+
+/*
+ * The answers are added to the pending response, except those multicast
+ * less than a second ago. The first pending answer starts the response timer,
+ * a TC query restarts it with the longer delay.
+ */
+static void HandleMulticast(const uint32_t* service_replies, bool is_truncated) {
+    MDNS_DEBUG_ENTRY();
+
+    for (uint32_t index = 0; index < static_cast<uint32_t>(kServiceRecordsMax); index++) {
+        auto replies = service_replies[index];
+
+        if (IsRecentlyMulticast(s_record_last_multicast[index].enumeration)) {
+            replies &= ~ServiceReply::kTypePtr;
+        }
+
+        if (IsRecentlyMulticast(s_record_last_multicast[index].service)) {
+            replies &= ~(ServiceReply::kNamePtr | ServiceReply::kSrv | ServiceReply::kTxt);
+        }
+
+        s_pending_service_replies[index] |= replies;
+    }
+
+    auto host_replies = s_host_replies;
+
+    if (IsRecentlyMulticast(s_host_last_multicast)) {
+        host_replies &= ~HostReply::kA;
+    }
+
+    s_pending_host_replies |= host_replies;
+
+    auto pending = s_pending_host_replies;
+
+    for (const auto kReplies : s_pending_service_replies) {
+        pending |= kReplies;
+    }
+
+    if (pending == 0) {
+        MDNS_DEBUG_EXIT();
+        return;
+    }
+
+    if (is_truncated) {
+        s_truncated_from_ip = s_n_remote_ip;
+        TimerStart(TruncatedDelay());
+    } else if (s_timer_id == kTimerIdNone) {
+        TimerStart(kResponseDelayMin + static_cast<uint32_t>(random()) % (1 + kResponseDelayMax - kResponseDelayMin));
+    }
+
+    MDNS_DEBUG_EXIT();
+}
+
+/*
+ * The replies of all questions are collected first, a record which is asked
+ * for in more than one question is answered once (duplicate question suppression).
+ */
+static void HandleQuestions(uint32_t questions, uint32_t answers, bool is_truncated) {
+    MDNS_DEBUG_ENTRY();
+    MDNS_DEBUG_PRINTF("questions=%u, answers=%u", static_cast<unsigned>(questions), static_cast<unsigned>(answers));
+
+    // A Known-Answer packet following a TC query
+    if (questions == 0) {
+        if ((s_truncated_from_ip == s_n_remote_ip) && (s_timer_id != kTimerIdNone)) {
+            HandleKnownAnswers(sizeof(struct network::dns::Header), answers, s_pending_service_replies, s_pending_host_replies);
+
+            if (is_truncated) {
+                TimerStart(TruncatedDelay());
+            }
+        }
+
+        MDNS_DEBUG_EXIT();
+        return;
+    }
 
     s_host_replies = 0;
     s_is_unicast = (s_n_remote_port != network::iana::Ports::kPortMdns);
@@ -847,19 +1356,21 @@ static void HandleQuestions(uint32_t questions) {
 
     const auto kTransactionID = s_is_legacy_query ? *reinterpret_cast<uint16_t*>(&s_p_receive_buffer[0]) : static_cast<uint16_t>(0);
 
+    uint32_t service_replies[kServiceRecordsMax] = {};
     uint32_t offset = sizeof(struct network::dns::Header);
 
     for (uint32_t i = 0; i < questions; i++) {
         Domain resource_domain;
 
-        auto* result = GetDomainName(s_p_receive_buffer, &s_p_receive_buffer[offset], &s_p_receive_buffer[s_n_bytes_received], resource_domain.a_name);
-        if (result == nullptr) {
+        if (GetDomain(offset, resource_domain) == nullptr) {
             MDNS_DEBUG_EXIT();
             return;
         }
 
-        resource_domain.length = static_cast<uint16_t>(result - &s_p_receive_buffer[offset]);
-        offset += resource_domain.length;
+        if (offset + 4 > s_n_bytes_received) {
+            MDNS_DEBUG_EXIT();
+            return;
+        }
 
         const auto kType = static_cast<network::dns::RRType>(__builtin_bswap16(*reinterpret_cast<uint16_t*>(&s_p_receive_buffer[offset])));
         offset += 2;
@@ -902,26 +1413,29 @@ static void HandleQuestions(uint32_t questions) {
         }
 #endif
 
-        for (auto& record : s_service_records) {
+        const auto kIsEnumeration = (kDomainDnssd == resource_domain);
+
+        for (uint32_t index = 0; index < static_cast<uint32_t>(kServiceRecordsMax); index++) {
+            const auto& record = s_service_records[index];
+
             if (record.services < Services::kLastNotUsed) {
                 /*
                  * Check service
                  */
 
-                s_service_replies = 0;
+                auto& replies = service_replies[index];
                 Domain service_domain;
 
                 if (kType == network::dns::RRType::kPtr || kType == network::dns::RRType::kAll) {
-                    if (kDomainDnssd == resource_domain) {
-                        s_service_replies = s_service_replies | ServiceReply::kTypePtr;
+                    if (kIsEnumeration) {
+                        replies = replies | ServiceReply::kTypePtr;
+                        continue;
                     }
 
                     CreateServiceDomain(service_domain, record, false);
 
                     if (service_domain == resource_domain) {
-                        s_service_replies = s_service_replies | ServiceReply::kNamePtr;
-                        s_service_replies = s_service_replies | ServiceReply::kSrv;
-                        s_service_replies = s_service_replies | ServiceReply::kTxt;
+                        replies = replies | ServiceReply::kNamePtr;
                     }
                 }
 
@@ -929,30 +1443,60 @@ static void HandleQuestions(uint32_t questions) {
 
                 if (service_domain == resource_domain) {
                     if ((kType == network::dns::RRType::kSrv) || (kType == network::dns::RRType::kAll)) {
-                        s_service_replies = s_service_replies | ServiceReply::kSrv;
+                        replies = replies | ServiceReply::kSrv;
                     }
 
                     if ((kType == network::dns::RRType::kTxt) || (kType == network::dns::RRType::kAll)) {
-                        s_service_replies = s_service_replies | ServiceReply::kTxt;
+                        replies = replies | ServiceReply::kTxt;
                     }
                 }
-
-                if (s_service_replies != 0) {
-                    SendMessage(record, kTransactionID, kMdnsResponseTtl);
-                }
             }
         }
     }
 
-    if (s_host_replies != 0) {
+    HandleKnownAnswers(offset, answers, service_replies, s_host_replies);
+
+    if (!s_is_unicast) {
+        HandleMulticast(service_replies, is_truncated);
+        MDNS_DEBUG_EXIT();
+        return;
+    }
+
+    for (uint32_t index = 0; index < static_cast<uint32_t>(kServiceRecordsMax); index++) {
+        const auto kReplies = service_replies[index];
+
+        if ((kReplies & ServiceReply::kTypePtr) == ServiceReply::kTypePtr) {
+            SendCached(s_record_caches[index].enumeration, kTransactionID);
+        }
+
+        // The service message holds PTR, SRV and TXT, it answers each of them
+        if ((kReplies & (ServiceReply::kNamePtr | ServiceReply::kSrv | ServiceReply::kTxt)) != 0) {
+            SendCached(s_record_caches[index].service, kTransactionID);
+        }
+    }
+
+#if defined(CONFIG_MDNS_DOMAIN_REVERSE)
+    if ((s_host_replies & HostReply::kPtr) == HostReply::kPtr) {
         MDNS_DEBUG_PUTS("");
         SendAnswerLocalIpAddress(kTransactionID, kMdnsResponseTtl);
+        MDNS_DEBUG_EXIT();
+        return;
+    }
+#endif
+
+    if (s_host_replies != 0) {
+        MDNS_DEBUG_PUTS("");
+        SendCached(s_host_cache, kTransactionID);
     }
 
     MDNS_DEBUG_EXIT();
 }
 
 static void Input(const uint8_t* buffer, uint32_t size, uint32_t from_ip, uint16_t from_port) {
+    if (size < sizeof(struct network::dns::Header)) {
+        return;
+    }
+
     s_p_receive_buffer = const_cast<uint8_t*>(buffer);
     s_n_bytes_received = size;
     s_n_remote_ip = from_ip;
@@ -961,20 +1505,28 @@ static void Input(const uint8_t* buffer, uint32_t size, uint32_t from_ip, uint16
     const auto* const kHeader = reinterpret_cast<network::dns::Header*>(s_p_receive_buffer);
     const auto kFlag1 = kHeader->flag1;
 
-    if ((kFlag1 >> 3) & 0xF) {
+    // Responses and queries with an opcode other than 0 (standard query) are ignored
+    if ((kFlag1 & static_cast<uint8_t>(network::dns::Flag1::kResponse)) || ((kFlag1 >> 3) & 0xF)) {
         return;
     }
 
-    HandleQuestions(static_cast<uint32_t>(__builtin_bswap16(kHeader->query_count)));
+    const auto kIsTruncated = ((kFlag1 & static_cast<uint8_t>(network::dns::Flag1::kTrunc)) != 0);
+
+    HandleQuestions(static_cast<uint32_t>(__builtin_bswap16(kHeader->query_count)), static_cast<uint32_t>(__builtin_bswap16(kHeader->answer_count)), kIsTruncated);
 }
 
 void Init() {
     MDNS_DEBUG_ENTRY();
 
-    for (auto& record : s_service_records) {
-        record.services = Services::kLastNotUsed;
+    const auto kLastMulticast = timing::Millis() - kMulticastInterval;
+
+    for (uint32_t index = 0; index < static_cast<uint32_t>(kServiceRecordsMax); index++) {
+        s_service_records[index].services = Services::kLastNotUsed;
+        s_record_last_multicast[index] = {kLastMulticast, kLastMulticast};
     }
 
+    s_host_last_multicast = kLastMulticast;
+
     s_handle = network::udp::Begin(network::iana::Ports::kPortMdns, Input);
     assert(s_handle != -1);
 
@@ -35,6 +35,7 @@
 #include "apps/tftpdaemon.h"
 #include "core/protocol/iana.h"
 #include "firmware/debug/debug_debug.h"
+#include "firmware/debug/debug_timeline.h"
 
 #if defined(DEBUG_NET_APPS_TFTP)
 #define TFTP_DEBUG_ENTRY() DEBUG_ENTRY()
@@ -159,6 +160,8 @@ void TFTPDaemon::Init() {
 }
 
 void TFTPDaemon::Input(const uint8_t* buffer, uint32_t size, uint32_t from_ip, uint16_t from_port) {
+    debug::timeline::Scope timeline(debug::timeline::Id::kTftpInput);
+
     buffer_ = const_cast<uint8_t*>(buffer);
     length_ = size;
     from_ip_ = from_ip;
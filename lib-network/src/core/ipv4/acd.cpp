@@ -67,9 +67,19 @@
 
 namespace network::acd {
 static constexpr uint32_t kAcdTmrInterval = 100;
-static constexpr uint32_t kAcdTicksPerSecond = (1000U / kAcdTmrInterval);
+#if defined(CONFIG_NET_ACD_FAST)
+static constexpr bool kPassive = true;
+#else
+static constexpr bool kPassive = false;
+#endif
+
+static constexpr uint16_t Ticks(uint32_t milliseconds) {
+    return static_cast<uint16_t>(milliseconds / kAcdTmrInterval);
+}
+
+static_assert(Ticks(kProbeWait) > 0 && Ticks(kProbeMax - kProbeMin) > 0);
 
-static TimerHandle_t s_timer_id;
+static TimerHandle_t s_timer_id = kTimerIdNone;
 
 static void Timer([[maybe_unused]] TimerHandle_t handle) {
     if (!netif::IsLinkUp()) {
@@ -77,7 +87,10 @@ static void Timer([[maybe_unused]] TimerHandle_t handle) {
     }
 
     auto* acd = reinterpret_cast<struct acd::Acd*>(netif::global::netif_default.acd);
-    assert(acd != nullptr);
+
+    if (acd == nullptr) {
+        return;
+    }
 
     if (acd->lastconflict > 0) {
         acd->lastconflict--;
@@ -100,30 +113,38 @@ static void Timer([[maybe_unused]] TimerHandle_t handle) {
                 if (acd->sent_num >= kProbeNum) {
                     acd->state = acd::State::kAcdStateAnnounceWait;
                     acd->sent_num = 0;
-                    acd->ttw = static_cast<uint16_t>(kAnnounceWait * acd::kAcdTicksPerSecond);
+                    acd->ttw = Ticks(kAnnounceWait);
                 } else {
-                    acd->ttw = static_cast<uint16_t>(static_cast<uint32_t>(random()) % (((kProbeMax - kProbeMin) * acd::kAcdTicksPerSecond)) + (kProbeMin * acd::kAcdTicksPerSecond));
+                    acd->ttw = static_cast<uint16_t>(static_cast<uint32_t>(random()) % Ticks(kProbeMax - kProbeMin) + Ticks(kProbeMin));
                 }
             }
             break;
         case acd::State::kAcdStateAnnounceWait:
         case acd::State::kAcdStateAnnouncing:
             if (acd->ttw == 0) {
+                // Passive: the address is in use since Start(), unless probing followed a conflict
+                auto is_in_use = kPassive;
+
                 if (acd->sent_num == 0) {
                     acd->state = acd::State::kAcdStateAnnouncing;
+                    is_in_use = kPassive && (acd->num_conflicts == 0);
                     acd->num_conflicts = 0;
                 }
                 arp::AcdSendAnnouncement(acd->ipaddr);
                 ACD_DEBUG_PUTS("ANNOUNCING Sent Announce");
-                acd->ttw = static_cast<uint16_t>(kAnnounceInterval * acd::kAcdTicksPerSecond);
+                acd->ttw = Ticks(kAnnounceInterval);
                 acd->sent_num++;
 
+                // RFC 5227, 2.3: the address may be used after the first announcement
+                if (!is_in_use && (acd->sent_num == 1)) {
+                    acd->conflict_callback(acd::Callback::kAcdIpOk);
+                }
+
+                // The timer keeps running for the defend interval of the ongoing detection
                 if (acd->sent_num >= kAnnounceNum) {
                     acd->state = acd::State::kAcdStateOngoing;
                     acd->sent_num = 0;
                     acd->ttw = 0;
-                    Stop(acd);
-                    acd->conflict_callback(acd::Callback::kAcdIpOk);
                 }
             }
             break;
@@ -144,7 +165,7 @@ static void Restart(struct acd::Acd* acd) {
 
     if (acd->num_conflicts >= kMaxConflicts) {
         acd->state = acd::State::kAcdStateRateLimit;
-        acd->ttw = static_cast<uint16_t>(kRateLimitInterval * acd::kAcdTicksPerSecond);
+        acd->ttw = Ticks(kRateLimitInterval);
         ACD_DEBUG_PUTS("rate limiting initiated. too many conflicts");
     } else {
         Stop(acd);
@@ -181,7 +202,7 @@ static void HandleArpConflict(struct acd::Acd* acd) {
         } else {
             ACD_DEBUG_PUTS("we are defending, send ARP Announce");
             arp::AcdSendAnnouncement(acd->ipaddr);
-            acd->lastconflict = kDefendInterval * acd::kAcdTicksPerSecond;
+            acd->lastconflict = static_cast<uint8_t>(Ticks(kDefendInterval));
         }
     }
 }
@@ -218,10 +239,19 @@ void Start(struct acd::Acd* acd, ip4_addr_t ipaddr) {
 
     acd->ipaddr.addr = ipaddr.addr;
     acd->state = acd::State::kAcdStateProbeWait;
-    acd->ttw = static_cast<uint16_t>(static_cast<uint32_t>(random()) % (kProbeWait * acd::kAcdTicksPerSecond));
+    acd->sent_num = 0;
+    acd->ttw = static_cast<uint16_t>(static_cast<uint32_t>(random()) % Ticks(kProbeWait));
+
+    if (s_timer_id == kTimerIdNone) {
+        s_timer_id = SoftwareTimerAdd(acd::kAcdTmrInterval, Timer);
+        assert(s_timer_id != kTimerIdNone);
+    }
 
-    s_timer_id = SoftwareTimerAdd(acd::kAcdTmrInterval, Timer);
-    assert(s_timer_id != kTimerIdNone);
+    // Passive: the address is used while probing, a conflict declines it.
+    // After a conflict the address is probed before it is used again.
+    if (kPassive && (acd->num_conflicts == 0)) {
+        acd->conflict_callback(acd::Callback::kAcdIpOk);
+    }
 
     ACD_DEBUG_EXIT();
 }
@@ -280,7 +310,7 @@ void ArpReply(const struct network::arp::Header* arp) {
              * ip.dst == ipaddr && hw.src != own macAddress (someone else is probing it)
              */
             if (((MemcpyIp(arp->arp.sender_ip) == acd->ipaddr.addr)) ||
-                (!(MemcpyIp(arp->arp.sender_ip) == 0) && ((MemcpyIp(arp->arp.target_ip)) == acd->ipaddr.addr) && (memcmp(arp->arp.sender_mac, netif::global::netif_default.hwaddr, network::ethernet::kAddressLength) == 0))) {
+                ((MemcpyIp(arp->arp.sender_ip) == 0) && ((MemcpyIp(arp->arp.target_ip)) == acd->ipaddr.addr) && (memcmp(arp->arp.sender_mac, netif::global::netif_default.hwaddr, network::ethernet::kAddressLength) != 0))) {
                 ACD_DEBUG_PUTS("Probe Conflict detected");
                 Restart(acd);
             }
@@ -77,6 +77,17 @@ static constexpr auto kMaxRecords = 16;
 static constexpr auto kMaxRecords = ARP_MAX_RECORDS;
 #endif
 
+#if !defined ARP_MAX_PENDING
+static constexpr auto kMaxPending = 3;
+#else
+static constexpr auto kMaxPending = ARP_MAX_PENDING;
+#endif
+
+static_assert(kMaxRecords > 0);
+static_assert(kMaxRecords < UINT8_MAX);
+static_assert(kMaxPending > 0);
+static_assert(kMaxPending <= 8);
+
 namespace network::globals {
 extern uint32_t on_network_mask;
 } // namespace network::globals
@@ -87,6 +98,17 @@ static constexpr uint32_t kMaxProbing = 2;           ///< 2 * 1 second
 static constexpr uint32_t kMaxReachable = (10 * 60); ///< (10 * 60) * 1 second = 10 minutes
 static constexpr uint32_t kMaxStale = (5 * 60);      ///< ( 5 * 60) * 1 second =  5 minutes
 
+/// Number of hash buckets: the power of two at least twice the number of records.
+static constexpr uint32_t kHashBits = [] {
+    uint32_t bits = 1;
+    while ((1U << bits) < (2U * kMaxRecords)) {
+        bits++;
+    }
+    return bits;
+}();
+static constexpr uint32_t kHashSize = (1U << kHashBits);
+static constexpr uint8_t kIndexNone = UINT8_MAX;
+
 enum class State {
     kStateEmpty,
     kStateProbe,
@@ -94,23 +116,36 @@ enum class State {
     kStateStale,
 };
 
-struct Packet {
-    uint8_t* p;
-    uint32_t size;
+/**
+ * Packets waiting for address resolution are kept in network::memory
+ * blocks; the record only stores the block index (the size is kept by the
+ * allocator).
+ */
+struct Pending {
+    uint16_t index[kMaxPending];
+    uint8_t count;
 #if defined CONFIG_NET_ENABLE_PTP
-    bool isTimestamp;
+    uint8_t is_timestamp; ///< Bit mask, one bit per queued packet
 #endif
 };
 
 struct Record {
     uint32_t ip;
-    Packet packet;
+    Pending pending;
     uint8_t mac_address[network::ethernet::kAddressLength];
     uint16_t age;
+    uint8_t hash_next; ///< Next record in the same hash bucket
+    uint8_t lru_prev;  ///< Towards most recently used
+    uint8_t lru_next;  ///< Towards least recently used
     State state;
 };
 
 static network::arp::Record s_arp_records[kMaxRecords] SECTION_NETWORK ALIGNED;
+static uint8_t s_hash_buckets[kHashSize] SECTION_NETWORK ALIGNED;
+static uint8_t s_lru_head SECTION_NETWORK; ///< Most recently used
+static uint8_t s_lru_tail SECTION_NETWORK; ///< Least recently used
+static uint8_t s_free_head SECTION_NETWORK;
+static network::arp::Record* s_last_record SECTION_NETWORK; ///< Fast path: last record used for sending
 static struct network::arp::Header s_arp_request SECTION_NETWORK ALIGNED;
 static struct network::arp::Header s_arp_reply SECTION_NETWORK ALIGNED;
 
@@ -123,14 +158,15 @@ static constexpr char kStates[4][12] = {
 };
 
 void static CacheRecordDump(network::arp::Record* record) {
-    printf("%p %-4d %c " MACSTR " %-10s " IPSTR "\n", record, record->age, record->packet.p == nullptr ? '-' : 'Q', MAC2STR(record->mac_address), kStates[static_cast<unsigned>(record->state)], IP2STR(record->ip));
+    printf("%p %-4d %u " MACSTR " %-10s " IPSTR "\n", record, record->age, static_cast<unsigned>(record->pending.count), MAC2STR(record->mac_address), kStates[static_cast<unsigned>(record->state)], IP2STR(record->ip));
 }
 
 void static CacheDump() {
-    uint32_t index = 0;
-    for (auto& record : s_arp_records) {
-        printf("%p %02d %-4d" MACSTR " %-10s " IPSTR "\n", &record, index++, record.age, MAC2STR(record.mac_address), kStates[static_cast<unsigned>(record.state)], IP2STR(record.ip));
-        if (index == 6) {
+    uint32_t count = 0;
+    for (auto index = s_lru_head; index != kIndexNone; index = s_arp_records[index].lru_next) {
+        auto& record = s_arp_records[index];
+        printf("%p %02d %-4d" MACSTR " %-10s " IPSTR "\n", &record, index, record.age, MAC2STR(record.mac_address), kStates[static_cast<unsigned>(record.state)], IP2STR(record.ip));
+        if (++count == 6) {
             return;
         }
     }
@@ -141,59 +177,184 @@ void static CacheRecordDump([[maybe_unused]] network::arp::Record* record) {}
 void static CacheDump() {}
 #endif
 
-static network::arp::Record* FindRecord(uint32_t destination_ip, [[maybe_unused]] arp::Flags flag) {
-    ARP_DEBUG_ENTRY();
+static inline uint32_t Hash(uint32_t ip) {
+    return (ip * 2654435769U) >> (32U - kHashBits); // Fibonacci hashing
+}
 
-    network::arp::Record* stale = nullptr;
-    network::arp::Record* reachable = nullptr;
-    uint32_t age_stale = 0;
-    uint32_t age_reachable = 0;
+static inline uint8_t IndexOf(const network::arp::Record* record) {
+    return static_cast<uint8_t>(record - s_arp_records);
+}
 
-    for (auto& record : s_arp_records) {
-        if (record.ip == destination_ip) {
-            ARP_DEBUG_EXIT();
-            return &record;
-        }
+static void LruUnlink(network::arp::Record& record) {
+    if (record.lru_prev != kIndexNone) {
+        s_arp_records[record.lru_prev].lru_next = record.lru_next;
+    } else {
+        s_lru_head = record.lru_next;
+    }
 
-        if (flag == arp::Flags::kFlagUpdate) {
-            continue;
-        }
+    if (record.lru_next != kIndexNone) {
+        s_arp_records[record.lru_next].lru_prev = record.lru_prev;
+    } else {
+        s_lru_tail = record.lru_prev;
+    }
 
-        if (record.state == network::arp::State::kStateEmpty) {
-            record.ip = destination_ip;
-            ARP_DEBUG_EXIT();
-            return &record;
-        }
+    record.lru_prev = kIndexNone;
+    record.lru_next = kIndexNone;
+}
 
-        if (record.state == network::arp::State::kStateReachable) {
-            if (record.age > age_reachable) {
-                age_reachable = record.age;
-                reachable = &record;
-            }
-            continue;
+static void LruPushFront(network::arp::Record& record) {
+    const auto kIndex = IndexOf(&record);
+
+    record.lru_prev = kIndexNone;
+    record.lru_next = s_lru_head;
+
+    if (s_lru_head != kIndexNone) {
+        s_arp_records[s_lru_head].lru_prev = kIndex;
+    } else {
+        s_lru_tail = kIndex;
+    }
+
+    s_lru_head = kIndex;
+}
+
+static inline void LruTouch(network::arp::Record& record) {
+    if (s_lru_head != IndexOf(&record)) {
+        LruUnlink(record);
+        LruPushFront(record);
+    }
+}
+
+static void HashUnlink(network::arp::Record& record) {
+    auto* link = &s_hash_buckets[Hash(record.ip)];
+    const auto kIndex = IndexOf(&record);
+
+    while (*link != kIndexNone) {
+        if (*link == kIndex) {
+            *link = record.hash_next;
+            record.hash_next = kIndexNone;
+            return;
         }
+        link = &s_arp_records[*link].hash_next;
+    }
+}
 
-        if (record.state == network::arp::State::kStateStale) {
-            if (record.age > age_stale) {
-                age_stale = record.age;
-                stale = &record;
-            }
-            continue;
+static network::arp::Record* Lookup(uint32_t ip) {
+    for (auto index = s_hash_buckets[Hash(ip)]; index != kIndexNone; index = s_arp_records[index].hash_next) {
+        if (s_arp_records[index].ip == ip) {
+            return &s_arp_records[index];
         }
     }
 
-    if (stale != nullptr) {
-        ARP_DEBUG_EXIT();
-        return stale;
+    return nullptr;
+}
+
+static void PendingClear(network::arp::Pending& pending) {
+    for (uint32_t i = 0; i < pending.count; i++) {
+        network::memory::Allocator::Instance().Free(pending.index[i]);
+    }
+
+    pending.count = 0;
+#if defined CONFIG_NET_ENABLE_PTP
+    pending.is_timestamp = 0;
+#endif
+}
+
+static void CacheCleanRecord(network::arp::Record& record) {
+    PendingClear(record.pending);
+
+    HashUnlink(record);
+    LruUnlink(record);
+
+    if (s_last_record == &record) {
+        s_last_record = nullptr;
+    }
+
+    record.ip = 0;
+    record.age = 0;
+    record.state = network::arp::State::kStateEmpty;
+    std::memset(record.mac_address, 0, network::ethernet::kAddressLength);
+
+    record.hash_next = s_free_head;
+    s_free_head = IndexOf(&record);
+}
+
+/**
+ * Evict the least recently used record. Records that are still being
+ * resolved are skipped, unless nothing else is left.
+ */
+static network::arp::Record* Evict() {
+    auto index = s_lru_tail;
+
+    while ((index != kIndexNone) && (s_arp_records[index].state == network::arp::State::kStateProbe)) {
+        index = s_arp_records[index].lru_prev;
+    }
+
+    if (index == kIndexNone) {
+        index = s_lru_tail;
     }
 
-    if (reachable != nullptr) {
+    assert(index != kIndexNone);
+
+    ARP_DEBUG_PRINTF("Evict " IPSTR, IP2STR(s_arp_records[index].ip));
+
+    CacheCleanRecord(s_arp_records[index]);
+
+    return &s_arp_records[index];
+}
+
+static network::arp::Record* FindRecord(uint32_t destination_ip, arp::Flags flag) {
+    ARP_DEBUG_ENTRY();
+
+    auto* record = Lookup(destination_ip);
+
+    if ((record != nullptr) || (flag == arp::Flags::kFlagUpdate)) {
         ARP_DEBUG_EXIT();
-        return reachable;
+        return record;
     }
 
+    if (s_free_head == kIndexNone) {
+        Evict();
+    }
+
+    assert(s_free_head != kIndexNone);
+
+    record = &s_arp_records[s_free_head];
+    s_free_head = record->hash_next;
+
+    record->ip = destination_ip;
+
+    const auto kBucket = Hash(destination_ip);
+    record->hash_next = s_hash_buckets[kBucket];
+    s_hash_buckets[kBucket] = IndexOf(record);
+
+    LruPushFront(*record);
+
     ARP_DEBUG_EXIT();
-    return nullptr;
+    return record;
+}
+
+static void SendPending(network::arp::Record& record) {
+    auto& pending = record.pending;
+
+    for (uint32_t i = 0; i < pending.count; i++) {
+        uint32_t size;
+        auto* packet = network::memory::Allocator::Instance().Get(pending.index[i], size);
+        auto* ip4 = reinterpret_cast<struct network::ip4::Header*>(packet);
+
+        std::memcpy(ip4->ether.dst, record.mac_address, network::ethernet::kAddressLength);
+        debug::Dump(packet, size);
+#if defined CONFIG_NET_ENABLE_PTP
+        if ((pending.is_timestamp & (1U << i)) == 0) {
+#endif
+            emac::eth::Send(packet, size);
+#if defined CONFIG_NET_ENABLE_PTP
+        } else {
+            emac::eth::SendTimestamp(packet, size);
+        }
+#endif
+    }
+
+    PendingClear(pending);
 }
 
 static void CacheUpdate(const uint8_t* mac_address, uint32_t ip, arp::Flags flag) {
@@ -212,27 +373,12 @@ static void CacheUpdate(const uint8_t* mac_address, uint32_t ip, arp::Flags flag
     record->age = 0;
     std::memcpy(record->mac_address, mac_address, network::ethernet::kAddressLength);
 
+    LruTouch(*record);
+
     CacheRecordDump(record);
 
-    if (record->packet.p != nullptr) {
-        auto* udp = reinterpret_cast<struct network::udp::Header*>(record->packet.p);
-        std::memcpy(udp->ether.dst, record->mac_address, network::ethernet::kAddressLength);
-        udp->ip4.chksum = 0;
-#if !defined(CHECKSUM_BY_HARDWARE)
-        udp->ip4.chksum = Chksum(reinterpret_cast<void*>(&udp->ip4), sizeof(udp->ip4));
-#endif
-#if defined CONFIG_NET_ENABLE_PTP
-        if (!record->packet.isTimestamp) {
-#endif
-            debug::Dump(record->packet.p, record->packet.size);
-            emac::eth::Send(record->packet.p, record->packet.size);
-#if defined CONFIG_NET_ENABLE_PTP
-        } else {
-            emac::eth::SendTimestamp(record->packet.p, record->packet.size);
-        }
-#endif
-        network::memory::Allocator::Instance().Free(record->packet.p);
-        record->packet.p = nullptr;
+    if (record->pending.count != 0) {
+        SendPending(*record);
     }
 
     ARP_DEBUG_EXIT();
@@ -246,7 +392,41 @@ static void SendRequest(uint32_t ip) {
     emac::eth::Send(reinterpret_cast<void*>(&s_arp_request), sizeof(struct network::arp::Header));
 }
 
-template <network::arp::EthSend S> static void Query(uint32_t destination_ip, void* packet, uint32_t size, [[maybe_unused]] arp::Flags flag) {
+/**
+ * Queue the packet until the address is resolved. When the queue is full,
+ * the oldest packet is dropped (RFC 1122, 2.3.2.2: save at least the latest).
+ */
+template <network::arp::EthSend S> static void Enqueue(network::arp::Record& record, void* packet, uint32_t size) {
+    assert(size <= network::memory::kBlockSize);
+
+    auto& pending = record.pending;
+
+    if (pending.count == kMaxPending) {
+        network::memory::Allocator::Instance().Free(pending.index[0]);
+        pending.count--;
+        for (uint32_t i = 0; i < pending.count; i++) {
+            pending.index[i] = pending.index[i + 1];
+        }
+#if defined CONFIG_NET_ENABLE_PTP
+        pending.is_timestamp = static_cast<uint8_t>(pending.is_timestamp >> 1);
+#endif
+    }
+
+    const auto kIndex = network::memory::Allocator::Instance().Allocate(reinterpret_cast<const uint8_t*>(packet), static_cast<uint16_t>(size));
+
+    if (kIndex == UINT16_MAX) {
+        return;
+    }
+
+#if defined CONFIG_NET_ENABLE_PTP
+    if constexpr (S == network::arp::EthSend::kIsTimestamp) {
+        pending.is_timestamp = static_cast<uint8_t>(pending.is_timestamp | (1U << pending.count));
+    }
+#endif
+    pending.index[pending.count++] = kIndex;
+}
+
+template <network::arp::EthSend S> static void Query(uint32_t destination_ip, void* packet, uint32_t size, arp::Flags flag) {
     ARP_DEBUG_ENTRY();
     ARP_DEBUG_PRINTF(IPSTR " %c", IP2STR(destination_ip), flag == arp::Flags::kFlagUpdate ? 'U' : 'I');
 
@@ -256,36 +436,18 @@ template <network::arp::EthSend S> static void Query(uint32_t destination_ip, vo
     CacheRecordDump(record_found);
 
     if (record_found->state == network::arp::State::kStateEmpty) {
-        if (record_found->packet.p != nullptr) {
-            network::memory::Allocator::Instance().Free(record_found->packet.p);
-        }
-
-        printf("size=%u\n", static_cast<unsigned>(size));
-        assert(size <= network::memory::kBlockSize);
-        record_found->packet.p = network::memory::Allocator::Instance().Allocate();
-        assert(record_found->packet.p != nullptr);
+        Enqueue<S>(*record_found, packet, size);
 
-        std::memcpy(record_found->packet.p, packet, size);
-        record_found->packet.size = size;
-#if defined CONFIG_NET_ENABLE_PTP
-        record_found->packet.isTimestamp = (S != network::arp::EthSend::kIsNormal);
-#endif
         record_found->state = network::arp::State::kStateProbe;
         record_found->age = 0;
         SendRequest(destination_ip);
+    } else if (record_found->state == network::arp::State::kStateProbe) {
+        Enqueue<S>(*record_found, packet, size);
     }
 
     ARP_DEBUG_EXIT();
 }
 
-static void CacheCleanRecord(network::arp::Record& record) {
-    if (record.packet.p != nullptr) {
-        network::memory::Allocator::Instance().Free(record.packet.p);
-    }
-
-    std::memset(&record, 0, sizeof(struct network::arp::Record));
-}
-
 static void SendRequestUnicast(uint32_t ip, const uint8_t* mac_address) {
     ARP_DEBUG_PRINTF(IPSTR, IP2STR(ip));
 
@@ -354,10 +516,20 @@ static void SendReply(const struct network::arp::Header* p_arp) {
 void __attribute__((cold)) Init() {
     ARP_DEBUG_ENTRY();
 
-    for (auto& record : s_arp_records) {
+    for (uint32_t index = 0; index < kMaxRecords; index++) {
+        auto& record = s_arp_records[index];
         std::memset(&record, 0, sizeof(struct network::arp::Record));
+        record.hash_next = (index + 1 < kMaxRecords) ? static_cast<uint8_t>(index + 1) : kIndexNone;
+        record.lru_prev = kIndexNone;
+        record.lru_next = kIndexNone;
     }
 
+    std::memset(s_hash_buckets, kIndexNone, sizeof(s_hash_buckets));
+    s_free_head = 0;
+    s_lru_head = kIndexNone;
+    s_lru_tail = kIndexNone;
+    s_last_record = nullptr;
+
     // ARP Request template
     // Ethernet header
     std::memcpy(s_arp_request.ether.src, netif::global::netif_default.hwaddr, network::ethernet::kAddressLength);
@@ -436,6 +608,10 @@ __attribute__((hot)) void Input(const struct network::arp::Header* arp) {
     }
 }
 
+/*
+ * The packet carries a complete IPv4 header, including destination and checksum.
+ * Only the Ethernet destination is filled in here.
+ */
 template <network::arp::EthSend S> static void SendImplementation(void* packet, uint32_t size, uint32_t remote_ip) {
     ARP_DEBUG_ENTRY();
     ARP_DEBUG_PRINTF(IPSTR, IP2STR(remote_ip));
@@ -450,12 +626,6 @@ template <network::arp::EthSend S> static void SendImplementation(void* packet,
 
     auto* p = reinterpret_cast<struct network::ip4::Header*>(packet);
 
-    network::MemcpyIp(p->ip4.dst, remote_ip);
-    p->ip4.chksum = 0;
-#if !defined(CHECKSUM_BY_HARDWARE)
-    p->ip4.chksum = Chksum(reinterpret_cast<void*>(&p->ip4), sizeof(p->ip4));
-#endif
-
     auto destination_ip = remote_ip;
 
     if (__builtin_expect((network::global::on_network_mask != (remote_ip & network::global::on_network_mask)), 0)) {
@@ -469,23 +639,30 @@ template <network::arp::EthSend S> static void SendImplementation(void* packet,
         }
     }
 
-    for (auto& record : s_arp_records) {
-        if (record.state >= network::arp::State::kStateReachable) {
-            if (record.ip == destination_ip) {
-                std::memcpy(p->ether.dst, record.mac_address, network::ethernet::kAddressLength);
+    auto* record = s_last_record;
+
+    if ((record == nullptr) || (record->ip != destination_ip)) {
+        record = Lookup(destination_ip);
+    }
+
+    if ((record != nullptr) && (record->state >= network::arp::State::kStateReachable)) {
+        std::memcpy(p->ether.dst, record->mac_address, network::ethernet::kAddressLength);
+
+        LruTouch(*record);
+        s_last_record = record;
 
-                if constexpr (S == network::arp::EthSend::kIsNormal) {
-                    emac::eth::Send(packet, size);
-                }
+        if constexpr (S == network::arp::EthSend::kIsNormal) {
+            emac::eth::Send(packet, size);
+        } else if constexpr (S == network::arp::EthSend::kIsQueue) {
+            emac::eth::SendQueue(packet, size);
+        }
 #if defined CONFIG_NET_ENABLE_PTP
-                else if constexpr (S == network::arp::EthSend::kIsTimestamp) {
-                    emac::eth::SendTimestamp(packet, size);
-                }
-#endif
-                ARP_DEBUG_EXIT();
-                return;
-            }
+        else if constexpr (S == network::arp::EthSend::kIsTimestamp) {
+            emac::eth::SendTimestamp(packet, size);
         }
+#endif
+        ARP_DEBUG_EXIT();
+        return;
     }
 
     Query<S>(destination_ip, packet, size, arp::Flags::kFlagInsert);
@@ -497,6 +674,10 @@ void Send(void* packet, uint32_t size, uint32_t remote_ip) {
     SendImplementation<network::arp::EthSend::kIsNormal>(packet, size, remote_ip);
 }
 
+void SendQueue(void* packet, uint32_t size, uint32_t remote_ip) {
+    SendImplementation<network::arp::EthSend::kIsQueue>(packet, size, remote_ip);
+}
+
 #if defined CONFIG_NET_ENABLE_PTP
 void SendTimestamp(void* packet, uint32_t size, uint32_t remote_ip) {
     SendImplementation<network::arp::EthSend::kIsTimestamp>(packet, size, remote_ip);
@@ -27,6 +27,7 @@
 
 #include <cstdint>
 #include <cstring>
+#include <cstdlib> // IWYU pragma: keep // Needed for random())
 #include <cassert>
 
 #include "softwaretimers.h" // IWYU pragma: keep
@@ -37,6 +38,7 @@
 #include "core/ip4/dhcp.h"
 #include "core/protocol/dhcp.h"
 #include "core/protocol/iana.h"
+#include "network_store.h"
 #if defined(CONFIG_NET_DHCP_USE_ACD)
 #include "core/ip4/acd.h"
 #endif
@@ -65,6 +67,7 @@
 #define REBOOT_TRIES 2
 
 static TimerHandle_t s_timer_id;
+static TimerHandle_t s_start_timer_id = kTimerIdNone;
 
 // https://tools.ietf.org/html/rfc1541
 namespace network::dhcp {
@@ -172,10 +175,13 @@ static void SendRequest() {
     MemcpyIp(&s_dhcp_message.options[k], dhcp->offered.offered_ip_addr.addr);
     k = k + 4;
 
-    s_dhcp_message.options[k++] = dhcp::Options::kServerIdentifier;
-    s_dhcp_message.options[k++] = 0x04;
-    MemcpyIp(&s_dhcp_message.options[k], dhcp->server_ip_addr.addr);
-    k = k + 4;
+    // RFC 2131, 4.3.2 INIT-REBOOT: 'server identifier' MUST NOT be filled in
+    if (dhcp->state != dhcp::State::kRebooting) {
+        s_dhcp_message.options[k++] = dhcp::Options::kServerIdentifier;
+        s_dhcp_message.options[k++] = 0x04;
+        MemcpyIp(&s_dhcp_message.options[k], dhcp->server_ip_addr.addr);
+        k = k + 4;
+    }
 
     s_dhcp_message.options[k++] = dhcp::Options::kHostname;
     s_dhcp_message.options[k++] = 0; // length of hostname
@@ -298,6 +304,12 @@ void Inform() {
 #define DHCP_NEXT_TIMEOUT_THRESHOLD ((60 + network::dhcp::kCoarseTimerSecs / 2) / network::dhcp::kCoarseTimerSecs)
 #define DHCP_REQUEST_BACKOFF_SEQUENCE(tries) (((tries) < 6U ? 1U << (tries) : 60U) * 1000U)
 
+// RFC 2131, 4.1: the retransmission delay is randomized by -1 to +1 second
+static dhcp::dhcp_timeout_t BackoffTimeout(uint32_t msecs) {
+    msecs = msecs - 1000U + static_cast<uint32_t>(random()) % 2001U;
+    return static_cast<dhcp::dhcp_timeout_t>((msecs + dhcp::kFineTimerMsecs - 1) / dhcp::kFineTimerMsecs);
+}
+
 static void SetState(struct dhcp::Dhcp* dhcp, dhcp::State new_state) {
     if (new_state != dhcp->state) {
         DHCP_DEBUG_PRINTF("%u -> %u", static_cast<unsigned>(dhcp->state), static_cast<unsigned>(new_state));
@@ -364,6 +376,9 @@ static void Bind() {
     netif::SetFlags(netif::Netif::kNetifFlagDhcpOk);
     netif::SetAddr(dhcp->offered.offered_ip_addr, sn_mask, gw_addr);
 
+    // Only written when the address has changed
+    network::store::SaveDhcpLease(dhcp->offered.offered_ip_addr.addr);
+
     DHCP_DEBUG_EXIT();
 }
 
@@ -481,8 +496,7 @@ static void Discover() {
         dhcp->tries++;
     }
 
-    const auto kMsecs = DHCP_REQUEST_BACKOFF_SEQUENCE(dhcp->tries);
-    dhcp->request_timeout = static_cast<uint16_t>((kMsecs + dhcp::kFineTimerMsecs - 1) / dhcp::kFineTimerMsecs);
+    dhcp->request_timeout = BackoffTimeout(DHCP_REQUEST_BACKOFF_SEQUENCE(dhcp->tries));
 }
 
 static void Reboot() {
@@ -492,6 +506,7 @@ static void Reboot() {
 
     SetState(dhcp, dhcp::State::kRebooting);
 
+    UpdateMsg(dhcp::Type::kRequest);
     SendRequest();
 
     if (dhcp->tries < 255) {
@@ -524,8 +539,15 @@ static void Timeout() {
     auto* dhcp = reinterpret_cast<struct dhcp::Dhcp*>(netif::global::netif_default.dhcp);
     assert(dhcp != nullptr);
 
-    /* back-off period has passed, or server selection timed out */
-    if ((dhcp->state == dhcp::State::kBackingOff) || (dhcp->state == dhcp::State::kSelecting)) {
+    /* start delay has passed */
+    if (dhcp->state == dhcp::State::kInit) {
+        if (dhcp->offered.offered_ip_addr.addr != 0) {
+            Reboot();
+        } else {
+            Discover();
+        }
+        /* back-off period has passed, or server selection timed out */
+    } else if ((dhcp->state == dhcp::State::kBackingOff) || (dhcp->state == dhcp::State::kSelecting)) {
         Discover();
         /* receiving the requested lease timed out */
     } else if (dhcp->state == dhcp::State::kRequesting) {
@@ -539,6 +561,8 @@ static void Timeout() {
         if (dhcp->tries < REBOOT_TRIES) {
             Reboot();
         } else {
+            // The reboot tries do not count for the DISCOVER back-off and AutoIP
+            dhcp->tries = 0;
             Discover();
         }
     }
@@ -611,6 +635,30 @@ static void FineTmr([[maybe_unused]] TimerHandle_t handle) {
     }
 }
 
+// One-shot, sends the first REQUEST or DISCOVER
+static void StartTmr([[maybe_unused]] TimerHandle_t handle) {
+    SoftwareTimerDelete(s_start_timer_id);
+
+    auto* dhcp = reinterpret_cast<struct dhcp::Dhcp*>(netif::global::netif_default.dhcp);
+
+    if ((dhcp != nullptr) && (dhcp->state == dhcp::State::kInit)) {
+        Timeout();
+    }
+}
+
+// RFC 2131, 4.4.1: wait a random time before the first message, in milliseconds as the fine timer is too coarse
+static void StartDelay() {
+    if (s_start_timer_id != kTimerIdNone) {
+        return;
+    }
+
+    s_start_timer_id = SoftwareTimerAdd(1U + static_cast<uint32_t>(random()) % dhcp::kStartDelayMaxMsecs, StartTmr);
+
+    if (s_start_timer_id == kTimerIdNone) {
+        Timeout();
+    }
+}
+
 static void HandleOffer(const dhcp::Message* const kResponse) {
     DHCP_DEBUG_ENTRY();
     auto* dhcp = reinterpret_cast<struct dhcp::Dhcp*>(netif::global::netif_default.dhcp);
@@ -662,6 +710,8 @@ static void HandleNak() {
     // Change to a defined state - set this before assigning the address
     // to ensure the callback can use dhcp_supplied_address()
     SetState(dhcp, dhcp::State::kBackingOff);
+    // The lease is no longer valid, do not request it again at the next startup
+    network::store::SaveDhcpLease(0);
     // remove IP address from interface (must no longer be used, as per RFC2131)
     ip4_addr_t any;
     any.addr = 0;
@@ -672,8 +722,9 @@ static void HandleNak() {
     DHCP_DEBUG_EXIT();
 }
 
-bool Start() {
+bool Start(uint32_t requested_ip) {
     DHCP_DEBUG_ENTRY();
+    DHCP_DEBUG_PRINTF(IPSTR, IP2STR(requested_ip));
     auto* dhcp = reinterpret_cast<struct dhcp::Dhcp*>(netif::global::netif_default.dhcp);
 
     if (dhcp == nullptr) {
@@ -696,16 +747,22 @@ bool Start() {
 
     MessageInit();
 
+    // Nodes with the same firmware must not pick the same transaction IDs
+    dhcp->xid = static_cast<uint32_t>(random()) ^ network::MemcpyIp(&netif::global::netif_default.hwaddr[2]);
+    // An erased store reads as the broadcast address
+    dhcp->offered.offered_ip_addr.addr = (requested_ip != network::kIpaddrBroadcast) ? requested_ip : 0;
+
 #if defined(CONFIG_NET_DHCP_USE_ACD)
     network::acd::Add(&dhcp->acd, ConflictCallback);
 #endif
 
+    SetState(dhcp, dhcp::State::kInit);
+
     if (!netif::IsLinkUp()) {
-        SetState(dhcp, dhcp::State::kInit);
         return false;
     }
 
-    Discover();
+    StartDelay();
 
     DHCP_DEBUG_EXIT();
     return true;
@@ -750,6 +807,10 @@ void ReleaseAndStop() {
     acd::Remove(&dhcp->acd);
 #endif
 
+    if (s_start_timer_id != kTimerIdNone) {
+        SoftwareTimerDelete(s_start_timer_id);
+    }
+
     delete reinterpret_cast<struct dhcp::Dhcp*>(netif::global::netif_default.dhcp);
     netif::global::netif_default.dhcp = nullptr;
     netif::ClearFlags(netif::Netif::kNetifFlagDhcpOk);
@@ -774,6 +835,9 @@ void NetworkChangedLinkUp() {
             break;
         case dhcp::State::kOff:
             break;
+        case dhcp::State::kInit:
+            StartDelay();
+            break;
         default:
             dhcp->tries = 0;
             Discover();
@@ -797,8 +861,8 @@ void Process(const dhcp::Message* const kResponse, uint32_t size) {
     dhcp->server_ip_addr.addr = 0;
 
     const auto* p = reinterpret_cast<const uint8_t*>(kResponse);
+    const auto* e = p + size;
     p = p + sizeof(dhcp::Message) - dhcp::kOptSize + 4;
-    auto* e = p + size;
 
     while (p < e) {
         switch (*p) {
@@ -78,16 +78,11 @@ __attribute__((hot)) void Input(struct Header* p_icmp) {
                 network::MemcpyIp(p_icmp->ip4.src, netif::global::netif_default.ip.addr);
             }
 
-            p_icmp->ip4.chksum = 0;
-#if !defined(CHECKSUM_BY_HARDWARE)
-            p_icmp->ip4.chksum = Chksum(reinterpret_cast<void*>(&p_icmp->ip4), 20); // TODO(avv)
-#endif
+            network::checksum::Ip4Header(p_icmp->ip4);
             // ICMP
             p_icmp->icmp.type = icmp::Type::kEchoReply;
-            p_icmp->icmp.checksum = 0;
-#if !defined(CHECKSUM_BY_HARDWARE)
-            p_icmp->icmp.checksum = Chksum(reinterpret_cast<void*>(&p_icmp->ip4), static_cast<uint32_t>(__builtin_bswap16(p_icmp->ip4.len)));
-#endif
+            const auto kIcmpLength = static_cast<uint32_t>(__builtin_bswap16(p_icmp->ip4.len)) - static_cast<uint32_t>(sizeof(struct network::ip4::Ip4Header));
+            network::checksum::Transport(&p_icmp->icmp.checksum, &p_icmp->icmp, kIcmpLength);
             emac::eth::Send(reinterpret_cast<void*>(p_icmp), static_cast<uint32_t>(sizeof(struct network::ethernet::Header) + __builtin_bswap16(p_icmp->ip4.len)));
         }
     }
@@ -111,14 +111,10 @@ static void SendReport(uint32_t group_address) {
     s_report.ip4.id = ++s_id;
     network::MemcpyIp(s_report.ip4.src, netif::global::netif_default.ip.addr);
     std::memcpy(s_report.ip4.dst, multicast_ip.u8, network::ip4::kAddressLength);
-    s_report.ip4.chksum = 0;
-#if !defined(CHECKSUM_BY_HARDWARE)
-    s_report.ip4.chksum = Chksum(reinterpret_cast<void*>(&s_report.ip4), 24); // TODO(avv)
-#endif
+    network::checksum::Ip4Header(s_report.ip4);
     // IGMP
     std::memcpy(s_report.igmp.report.igmp.group_address, multicast_ip.u8, network::ip4::kAddressLength);
-    s_report.igmp.report.igmp.checksum = 0;
-    s_report.igmp.report.igmp.checksum = Chksum(reinterpret_cast<void*>(&s_report.ip4), kIPv4IgmpReportHeadersSize);
+    network::checksum::Software(&s_report.igmp.report.igmp.checksum, &s_report.igmp.report.igmp, sizeof(struct Packet));
 
     emac::eth::Send(reinterpret_cast<void*>(&s_report), kReportPacketSize);
 
@@ -151,6 +147,33 @@ static void Timer([[maybe_unused]] TimerHandle_t handle) {
     }
 }
 
+#if defined(CONFIG_EMAC_HASH_MULTICAST_FILTER)
+static void FilterAdd(uint32_t group_address) {
+    pcast32 multicast_ip;
+    multicast_ip.u32 = group_address;
+    const uint8_t kMacAddr[6] = {0x01, 0x00, 0x5E, static_cast<uint8_t>(multicast_ip.u8[1] & 0x7F), multicast_ip.u8[2], multicast_ip.u8[3]};
+    IGMP_DEBUG_PRINTF(IPSTR " " MACSTR, IP2STR(group_address), MAC2STR(kMacAddr));
+    emac::multicast::Add(kMacAddr);
+}
+
+/*
+ * There is no way to remove a single address from the hash filter,
+ * therefore the filter is rebuilt from the group table on a leave.
+ * All-systems (224.0.0.1) is always passed, it carries the IGMP queries.
+ */
+static void FilterRebuild() {
+    emac::multicast::Reset();
+
+    FilterAdd(network::ConvertToUint(224, 0, 0, 1));
+
+    for (auto& group : s_groups) {
+        if (group.group_address != 0) {
+            FilterAdd(group.group_address);
+        }
+    }
+}
+#endif
+
 void __attribute__((cold)) Init() {
     s_multicast_mac[0] = 0x01;
     s_multicast_mac[1] = 0x00;
@@ -206,7 +229,8 @@ void __attribute__((cold)) Init() {
     assert(s_timer_id >= 0);
 
 #if defined(CONFIG_EMAC_HASH_MULTICAST_FILTER)
-    emac::multicast::EnableHashFilter();
+    emac::multicast::Enable();
+    FilterRebuild();
 #endif
 }
 
@@ -224,7 +248,7 @@ void __attribute__((cold)) Shutdown() {
     }
 
 #if defined(CONFIG_EMAC_HASH_MULTICAST_FILTER)
-    emac::multicast::DisableHashFilter();
+    emac::multicast::Disable();
 #endif
 
     IGMP_DEBUG_EXIT();
@@ -236,17 +260,11 @@ static void SendLeave(uint32_t group_address) {
 
     // IPv4
     s_leave.ip4.id = s_id;
-    s_leave.ip4.chksum = 0;
-#if !defined(CHECKSUM_BY_HARDWARE)
-    s_leave.ip4.chksum = Chksum(reinterpret_cast<void*>(&s_leave.ip4), 24); // TODO(avv):
-#endif
     network::MemcpyIp(s_leave.ip4.src, netif::global::netif_default.ip.addr);
+    network::checksum::Ip4Header(s_leave.ip4);
     // IGMP
     network::MemcpyIp(s_leave.igmp.report.igmp.group_address, group_address);
-    s_leave.igmp.report.igmp.checksum = 0;
-#if !defined(CHECKSUM_BY_HARDWARE)
-    s_leave.igmp.report.igmp.checksum = Chksum(reinterpret_cast<void*>(&s_leave.ip4), kIPv4IgmpReportHeadersSize);
-#endif
+    network::checksum::Software(&s_leave.igmp.report.igmp.checksum, &s_leave.igmp.report.igmp, sizeof(struct Packet));
 
     emac::eth::Send(reinterpret_cast<void*>(&s_leave), kReportPacketSize);
 
@@ -301,21 +319,6 @@ static void DelayingMember(struct GroupInfo& group, uint32_t maxresp) {
     }
 }
 
-#if defined(CONFIG_EMAC_HASH_MULTICAST_FILTER)
-static void ResetHash() {
-    emac::multicast::ResetHash();
-
-    for (auto& group : s_groups) {
-        if (group.group_address != 0) {
-            pcast32 multicast_ip;
-            multicast_ip.u32 = group.group_address;
-            const uint8_t kMacAddr[6] = {0x01, 0x00, 0x5E, static_cast<uint8_t>(multicast_ip.u8[1] & 0x7F), multicast_ip.u8[2], multicast_ip.u8[3]};
-
-            emac::multicast::SetHash(kMacAddr);
-        }
-    }
-}
-#endif
 
 void static Join(uint32_t group_address) {
     IGMP_DEBUG_ENTRY();
@@ -338,11 +341,7 @@ void static Join(uint32_t group_address) {
             s_groups[i].timer = 2; // TODO(avv):
 
 #if defined(CONFIG_EMAC_HASH_MULTICAST_FILTER)
-            pcast32 multicast_ip;
-            multicast_ip.u32 = group_address;
-            const uint8_t kMacAddr[6] = {0x01, 0x00, 0x5E, static_cast<uint8_t>(multicast_ip.u8[1] & 0x7F), multicast_ip.u8[2], multicast_ip.u8[3]};
-            IGMP_DEBUG_PRINTF(MACSTR, MAC2STR(kMacAddr));
-            emac::multicast::SetHash(kMacAddr);
+            FilterAdd(group_address);
 #endif
             SendReport(group_address);
 
@@ -368,7 +367,7 @@ static void Leave(uint32_t group_address) {
             group.timer = 0;
 
 #if defined(CONFIG_EMAC_HASH_MULTICAST_FILTER)
-            ResetHash();
+            FilterRebuild();
 #endif
             IGMP_DEBUG_EXIT();
             return;
@@ -0,0 +1,179 @@
+/**
+ * @file network_checksum.h
+ * @brief Internet checksum and the checksum offload policy of the stack.
+ *
+ * All protocol modules fill in checksum fields through these helpers so that
+ * CHECKSUM_BY_HARDWARE is honoured in one place. When defined, the ENET TX
+ * descriptors insert the IPv4 header and the TCP/UDP/ICMP payload checksums,
+ * and received frames with a checksum error are dropped by the MAC. IGMP is
+ * not covered by the checksum engine and is always computed in software.
+ */
+/* Copyright (C) 2026 by Arjan van Vught mailto:info@gd32-dmx.org
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef NETWORK_CHECKSUM_H_
+#define NETWORK_CHECKSUM_H_
+
+#include <cstdint>
+#include <cstring>
+
+#include "net_config.h"
+#include "core/protocol/ip4.h"
+
+namespace network {
+/**
+ * @brief RFC 1071 one's complement checksum.
+ *
+ * The data is summed as native-endian 32-bit words into a 64-bit accumulator,
+ * so carries never need to be handled inside the loop. The one's complement
+ * sum is byte-order independent, folding the result to 16 bits gives the same
+ * value as a 16-bit big-endian summation. The loads go through memcpy, the
+ * buffer does not need to be aligned.
+ */
+inline uint16_t Chksum(const void* data, uint32_t length) {
+    const auto* ptr = reinterpret_cast<const uint8_t*>(data);
+    uint64_t sum = 0;
+    uint32_t word;
+
+    while (length >= 16) {
+        memcpy(&word, ptr + 0, 4);
+        sum += word;
+        memcpy(&word, ptr + 4, 4);
+        sum += word;
+        memcpy(&word, ptr + 8, 4);
+        sum += word;
+        memcpy(&word, ptr + 12, 4);
+        sum += word;
+        ptr += 16;
+        length -= 16;
+    }
+
+    while (length >= 4) {
+        memcpy(&word, ptr, 4);
+        sum += word;
+        ptr += 4;
+        length -= 4;
+    }
+
+    if (length >= 2) {
+        uint16_t half;
+        memcpy(&half, ptr, 2);
+        sum += half;
+        ptr += 2;
+        length -= 2;
+    }
+
+    // Add left-over byte, if any
+    if (length > 0) {
+        sum += *ptr;
+    }
+
+    // Fold 64-bit sum into 16 bits
+    auto fold = static_cast<uint32_t>(sum >> 32) + static_cast<uint32_t>(sum);
+    if (fold < static_cast<uint32_t>(sum)) {
+        fold++;
+    }
+    fold = (fold >> 16) + (fold & 0xFFFF);
+    fold = (fold >> 16) + (fold & 0xFFFF);
+
+    return static_cast<uint16_t>(~fold);
+}
+
+namespace checksum {
+#if defined(CHECKSUM_BY_HARDWARE)
+inline constexpr bool kByHardware = true;
+#else
+inline constexpr bool kByHardware = false;
+#endif
+
+/**
+ * @brief Sets the IPv4 header checksum, the header length is taken from IHL.
+ *
+ * With hardware offload the field must be zero, the MAC inserts the checksum.
+ */
+inline void Ip4Header(struct ip4::Ip4Header& ip4) {
+    ip4.chksum = 0;
+    if constexpr (!kByHardware) {
+        ip4.chksum = Chksum(&ip4, static_cast<uint32_t>(ip4.ver_ihl & 0x0F) * 4U);
+    }
+}
+
+/**
+ * @brief Sets a TCP/UDP/ICMP checksum field.
+ *
+ * @param checksum Address of the checksum field inside the message.
+ * @param data Start of the data covered by the checksum (may include a pseudo header).
+ * @param length Number of bytes covered by the checksum.
+ *
+ * With hardware offload the field is left zero, the MAC computes the payload
+ * checksum including the pseudo header.
+ */
+inline void Transport(void* checksum, const void* data, uint32_t length) {
+    uint16_t value = 0;
+    memcpy(checksum, &value, sizeof(value));
+    if constexpr (!kByHardware) {
+        value = Chksum(data, length);
+        memcpy(checksum, &value, sizeof(value));
+    }
+}
+
+/**
+ * @brief RFC 1624 incremental update, eqn. 3: HC' = ~(~HC + ~m + m').
+ *
+ * @param checksum The checksum HC over the original data.
+ * @param m The original 16-bit field, as stored in the packet.
+ * @param m_new The new 16-bit field, as stored in the packet.
+ */
+inline uint16_t Update(uint16_t checksum, uint16_t m, uint16_t m_new) {
+    uint32_t sum = static_cast<uint32_t>(static_cast<uint16_t>(~checksum)) + static_cast<uint16_t>(~m) + m_new;
+    sum = (sum >> 16) + (sum & 0xFFFF);
+    sum = (sum >> 16) + (sum & 0xFFFF);
+
+    return static_cast<uint16_t>(~sum);
+}
+
+/**
+ * @brief RFC 1624 incremental update for fields that were zero in the original data.
+ *
+ * ~0 is negative zero and drops out of eqn. 3, leaving HC' = ~(~HC + m').
+ *
+ * @param checksum The checksum HC over the original data.
+ * @param sum The plain sum of the new 16-bit fields, as stored in the packet.
+ */
+inline uint16_t Update(uint16_t checksum, uint32_t sum) {
+    sum += static_cast<uint16_t>(~checksum);
+    sum = (sum >> 16) + (sum & 0xFFFF);
+    sum = (sum >> 16) + (sum & 0xFFFF);
+
+    return static_cast<uint16_t>(~sum);
+}
+
+/**
+ * @brief Sets a checksum field which is never offloaded (IGMP).
+ */
+inline void Software(void* checksum, const void* data, uint32_t length) {
+    uint16_t value = 0;
+    memcpy(checksum, &value, sizeof(value));
+    value = Chksum(data, length);
+    memcpy(checksum, &value, sizeof(value));
+}
+} // namespace checksum
+} // namespace network
+
+#endif // NETWORK_CHECKSUM_H_
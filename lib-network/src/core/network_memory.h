@@ -31,6 +31,7 @@
 #include <cassert>
 
 #include "network_private.h"
+#include "network_stats.h"
 
 namespace network::memory {
 inline constexpr uint32_t kBlocks =
@@ -84,6 +85,7 @@ class Allocator {
 
     uint8_t* Allocate() {
         if (IsFull()) {
+            network::stats::Dropped(network::stats::Drop::kPoolFull);
             network::Error(__func__, "Allocate:Full!");
             return nullptr;
         }
@@ -102,6 +104,7 @@ class Allocator {
         assert(size <= kBlockSize);
 
         if (IsFull()) {
+            network::stats::Dropped(network::stats::Drop::kPoolFull);
             network::Error(__func__, "Allocate:Full!");
             return UINT16_MAX;
         }
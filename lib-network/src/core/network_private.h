@@ -34,6 +34,7 @@
 #include "core/protocol/udp.h"
 #include "core/protocol/tcp.h"
 #include "net_platform.h" // IWYU pragma: keep
+#include "network_checksum.h"
 #include "ansi_colour.h"
 
 #ifndef ALIGNED
@@ -44,6 +45,9 @@ namespace emac::eth {
 uint8_t* SendGetDmaBuffer();
 void Send(uint32_t);
 void Send(void*, uint32_t);
+void SendQueue(uint32_t);
+void SendQueue(void*, uint32_t);
+void SendFlush();
 #if defined CONFIG_NET_ENABLE_PTP
 void SendTimestamp(uint32_t);
 void SendTimestamp(void*, uint32_t);
@@ -64,32 +68,10 @@ extern uint32_t broadcast_mask;
 extern uint32_t on_network_mask;
 } // namespace global
 
-inline uint16_t Chksum(const void* data, uint32_t length) {
-    const auto* ptr = reinterpret_cast<const uint16_t*>(data);
-    uint32_t sum = 0;
-
-    while (length > 1) {
-        sum += *ptr;
-        ptr++;
-        length -= 2;
-    }
-
-    // Add left-over byte, if any
-    if (length > 0) {
-        sum += __builtin_bswap16(static_cast<uint16_t>(*(reinterpret_cast<const uint8_t*>(ptr)) << 8));
-    }
-
-    // Fold 32-bit sum into 16 bits
-    while ((sum >> 16) != 0) {
-        sum = (sum >> 16) + (sum & 0xFFFF);
-    }
-
-    return static_cast<uint16_t>(~sum);
-}
-
 namespace arp {
 enum class EthSend {
-    kIsNormal
+    kIsNormal,
+    kIsQueue ///< Handed to the DMA, the caller resumes the TxDMA with SendFlush
 #if defined CONFIG_NET_ENABLE_PTP
     ,
     kIsTimestamp
@@ -0,0 +1,113 @@
+/**
+ * @file network_stats.cpp
+ *
+ */
+/* Copyright (C) 2026 by Arjan van Vught mailto:info@gd32-dmx.org
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#include "network_stats.h"
+#include "network_iface.h"
+
+namespace network::stats {
+#if defined(CONFIG_NET_ENABLE_STATS)
+namespace global {
+Stats stats;
+uint32_t rx_micros;
+} // namespace global
+
+// Ensure order matches enum class Protocol
+static constexpr const char* kProtocolNames[kProtocols] = {"arp", "icmp", "igmp", "udp", "tcp", "other"};
+// Ensure order matches enum class Drop
+static constexpr const char* kDropNames[kDrops] = {"no_port", "checksum", "pool_full", "multicast"};
+#endif
+
+void Reset() {
+#if defined(CONFIG_NET_ENABLE_STATS)
+    memset(&global::stats, 0, sizeof(global::stats));
+#endif
+}
+
+namespace {
+struct Writer {
+    char* buffer;
+    uint32_t size;
+    uint32_t length;
+
+    template <typename... Args> void Append(const char* format, Args... args) {
+        if (length >= size) {
+            return;
+        }
+
+        const auto kLength = snprintf(&buffer[length], size - length, format, args...);
+
+        if ((kLength < 0) || (static_cast<uint32_t>(kLength) >= (size - length))) {
+            buffer[length] = '\0';
+            size = length; // truncated, stop here
+            return;
+        }
+
+        length += static_cast<uint32_t>(kLength);
+    }
+};
+} // namespace
+
+uint32_t Format(char* buffer, uint32_t size) {
+    Writer writer{buffer, size, 0};
+
+    network::iface::Counters counters;
+    network::iface::GetCounters(counters);
+
+    writer.Append("mac rx ok %u err %u drp %u ovr %u\n", static_cast<unsigned>(counters.rx.ok), static_cast<unsigned>(counters.rx.err), static_cast<unsigned>(counters.rx.drp), static_cast<unsigned>(counters.rx.ovr));
+    writer.Append("mac tx ok %u err %u drp %u ovr %u\n", static_cast<unsigned>(counters.tx.ok), static_cast<unsigned>(counters.tx.err), static_cast<unsigned>(counters.tx.drp), static_cast<unsigned>(counters.tx.ovr));
+
+#if defined(CONFIG_NET_ENABLE_STATS)
+    const auto& stats = global::stats;
+
+    for (uint32_t i = 0; i < kProtocols; i++) {
+        writer.Append("%s rx %u tx %u\n", kProtocolNames[i], static_cast<unsigned>(stats.rx[i]), static_cast<unsigned>(stats.tx[i]));
+    }
+
+    // The RX DMA ran out of descriptors (missed) or the RX FIFO overflowed
+    writer.Append("drop rx_no_descriptor %u rx_fifo %u", static_cast<unsigned>(counters.rx.drp - counters.rx.ovr), static_cast<unsigned>(counters.rx.ovr));
+    for (uint32_t i = 0; i < kDrops; i++) {
+        writer.Append(" %s %u", kDropNames[i], static_cast<unsigned>(stats.drop[i]));
+    }
+
+    writer.Append("\ntx_busy %u wait_cycles %u\nlatency_us", static_cast<unsigned>(counters.tx.drp), static_cast<unsigned>(stats.tx_wait_cycles));
+    for (uint32_t i = 0; i < (kLatencyBuckets - 1); i++) {
+        writer.Append(" <%u:%u", 1U << i, static_cast<unsigned>(stats.latency[i]));
+    }
+    writer.Append(" >=%u:%u\n", 1U << (kLatencyBuckets - 2), static_cast<unsigned>(stats.latency[kLatencyBuckets - 1]));
+#endif
+
+    return writer.length;
+}
+
+void Print() {
+    char buffer[640];
+    Format(buffer, sizeof(buffer));
+    printf("Network statistics:\n%s", buffer);
+}
+} // namespace network::stats
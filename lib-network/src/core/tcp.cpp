@@ -453,10 +453,7 @@ static void SendSegment(Tcb* tcb, const SendInfo& send_info, bool track_rtx = tr
     s_eth_frame.ip4.len = __builtin_bswap16(static_cast<uint16_t>(kTcpLength + sizeof(struct network::ip4::Ip4Header)));
     std::memcpy(s_eth_frame.ip4.src, tcb->local_ip, network::ip4::kAddressLength);
     std::memcpy(s_eth_frame.ip4.dst, tcb->remote_ip, network::ip4::kAddressLength);
-    s_eth_frame.ip4.chksum = 0;
-#if !defined(CHECKSUM_BY_HARDWARE)
-    s_eth_frame.ip4.chksum = network::Chksum(reinterpret_cast<void*>(&s_eth_frame.ip4), 20);
-#endif
+    network::checksum::Ip4Header(s_eth_frame.ip4);
     // TCP
     s_eth_frame.tcp.srcpt = tcb->local_port;
     s_eth_frame.tcp.dstpt = tcb->remote_port;
@@ -503,7 +500,9 @@ static void SendSegment(Tcb* tcb, const SendInfo& send_info, bool track_rtx = tr
     s_eth_frame.tcp.window = __builtin_bswap16(s_eth_frame.tcp.window);
     s_eth_frame.tcp.urgent = __builtin_bswap16(s_eth_frame.tcp.urgent);
 
-    s_eth_frame.tcp.checksum = TcpChecksumPseudoHeader(&s_eth_frame, tcb, static_cast<uint16_t>(kTcpLength));
+    if constexpr (!network::checksum::kByHardware) {
+        s_eth_frame.tcp.checksum = TcpChecksumPseudoHeader(&s_eth_frame, tcb, static_cast<uint16_t>(kTcpLength));
+    }
 
     Ip4SendSegment(tcb, reinterpret_cast<void*>(&s_eth_frame), kTcpLength + sizeof(struct network::ip4::Ip4Header) + sizeof(struct ethernet::Header));
 
@@ -40,9 +40,11 @@
 #include "core/protocol/udp.h"
 #include "core/ip4/arp.h"
 #include "network_udp.h"
+#include "network_stats.h"
 #include "network_private.h"
 #include "network_memcpy.h"
 #include "firmware/debug/debug_debug.h"
+#include "firmware/debug/debug_timeline.h"
 
 #if defined(DEBUG_UDP)
 #define UDP_DEBUG_ENTRY() DEBUG_ENTRY()
@@ -82,7 +84,25 @@ struct Port {
     Data data ALIGNED;
 } ALIGNED;
 
+/*
+ * Pre-built Ethernet | IPv4 | UDP headers, one per port.
+ * Per send only the Ethernet destination, the IPv4 len, id and destination,
+ * and the UDP destination port and len are written. The IPv4 checksum is
+ * stored with these fields zero and is updated incrementally (RFC 1624).
+ */
+struct Template {
+    struct network::ethernet::Header ether;
+    struct network::ip4::Ip4Header ip4;
+    uint16_t source_port;
+    uint16_t destination_port;
+    uint16_t len;
+    uint16_t checksum;
+} PACKED;
+
+static_assert(sizeof(struct Template) == kUdpPacketHeadersSize);
+
 static Port s_ports[UDP_MAX_PORTS_ALLOWED] SECTION_NETWORK ALIGNED;
+static Template s_templates[UDP_MAX_PORTS_ALLOWED] SECTION_NETWORK ALIGNED;
 static uint16_t s_id SECTION_NETWORK ALIGNED;
 static uint8_t s_multicast_mac[network::ethernet::kAddressLength] SECTION_NETWORK ALIGNED;
 
@@ -100,6 +120,7 @@ void __attribute__((cold)) Shutdown() {
 }
 
 __attribute__((hot)) void Input(const struct Header* udp) {
+    debug::timeline::Scope timeline(debug::timeline::Id::kUdpInput);
     const auto kDestinationPort = __builtin_bswap16(udp->udp.destination_port);
 
     for (uint32_t port_index = 0; port_index < UDP_MAX_PORTS_ALLOWED; port_index++) {
@@ -123,6 +144,7 @@ __attribute__((hot)) void Input(const struct Header* udp) {
             emac::eth::FreePkt();
 
             if (info.callback != nullptr) {
+                network::stats::Delivered();
                 info.callback(data.data, kSize, data.from_ip, data.from_port);
             }
 
@@ -132,47 +154,72 @@ __attribute__((hot)) void Input(const struct Header* udp) {
 
     emac::eth::FreePkt();
 
+    network::stats::Dropped(network::stats::Drop::kNoPort);
+
     UDP_DEBUG_PRINTF(IPSTR ":%d[%x] " MACSTR, udp->ip4.src[0], udp->ip4.src[1], udp->ip4.src[2], udp->ip4.src[3], kDestinationPort, kDestinationPort, MAC2STR(udp->ether.dst));
 }
 
+static void TemplateBuild(int index) {
+    auto& t = s_templates[index];
+
+    // Ethernet
+    std::memcpy(t.ether.src, netif::global::netif_default.hwaddr, network::ethernet::kAddressLength);
+    t.ether.type = __builtin_bswap16(network::ethernet::Type::kIPv4);
+
+    // IPv4
+    t.ip4.ver_ihl = 0x45;
+    t.ip4.tos = 0;
+    t.ip4.len = 0;
+    t.ip4.id = 0;
+    t.ip4.flags_froff = __builtin_bswap16(network::ip4::Flags::kFlagDf);
+    t.ip4.ttl = 64;
+    t.ip4.proto = network::ip4::Proto::kUdp;
+    network::MemcpyIp(t.ip4.src, netif::global::netif_default.ip.addr);
+    network::Memset<0, network::ip4::kAddressLength>(t.ip4.dst);
+    network::checksum::Ip4Header(t.ip4);
+
+    // UDP
+    t.source_port = __builtin_bswap16(s_ports[index].info.port);
+    t.destination_port = 0;
+    t.len = 0;
+    t.checksum = 0;
+}
+
 template <network::arp::EthSend S> static void SendImplementation(int index, const uint8_t* data, uint32_t size, uint32_t remote_ip, uint16_t remote_port) {
     assert(index >= 0);
     assert(index < UDP_MAX_PORTS_ALLOWED);
     assert(s_ports[index].info.port != 0);
 
+    // The source address changes with DHCP, Zeroconf or a static change
+    if (__builtin_expect((network::MemcpyIp(s_templates[index].ip4.src) != netif::global::netif_default.ip.addr), 0)) {
+        TemplateBuild(index);
+    }
+
+    size = std::min(kDataSize, size);
+
     auto* out_buffer = reinterpret_cast<Header*>(emac::eth::SendGetDmaBuffer());
 
-    // Ethernet
-    std::memcpy(out_buffer->ether.src, netif::global::netif_default.hwaddr, network::ethernet::kAddressLength);
-    out_buffer->ether.type = __builtin_bswap16(network::ethernet::Type::kIPv4);
+    std::memcpy(out_buffer, &s_templates[index], kUdpPacketHeadersSize);
 
-    // IPv4
-    out_buffer->ip4.ver_ihl = 0x45;
-    out_buffer->ip4.tos = 0;
-    out_buffer->ip4.flags_froff = __builtin_bswap16(network::ip4::Flags::kFlagDf);
-    out_buffer->ip4.ttl = 64;
-    out_buffer->ip4.proto = network::ip4::Proto::kUdp;
-    out_buffer->ip4.id = ++s_id;
-    out_buffer->ip4.len = __builtin_bswap16(static_cast<uint16_t>(size + kIPv4UdpHeadersSize));
-    out_buffer->ip4.chksum = 0;
-    network::MemcpyIp(out_buffer->ip4.src, netif::global::netif_default.ip.addr);
+    const auto kIpLength = __builtin_bswap16(static_cast<uint16_t>(size + kIPv4UdpHeadersSize));
+    const auto kId = ++s_id;
+
+    out_buffer->ip4.len = kIpLength;
+    out_buffer->ip4.id = kId;
+    network::MemcpyIp(out_buffer->ip4.dst, remote_ip);
+
+    if constexpr (!network::checksum::kByHardware) {
+        const uint32_t kSum = static_cast<uint32_t>(kIpLength) + kId + (remote_ip & 0xFFFF) + (remote_ip >> 16);
+        out_buffer->ip4.chksum = network::checksum::Update(s_templates[index].ip4.chksum, kSum);
+    }
 
-    // UDP
-    out_buffer->udp.source_port = __builtin_bswap16(s_ports[index].info.port);
     out_buffer->udp.destination_port = __builtin_bswap16(remote_port);
     out_buffer->udp.len = __builtin_bswap16(static_cast<uint16_t>(size + kHeaderSize));
-    out_buffer->udp.checksum = 0;
-
-    size = std::min(kDataSize, size);
 
     std::memcpy(out_buffer->udp.data, data, size);
 
-    if (remote_ip == network::kIpaddrBroadcast) {
+    if ((remote_ip & network::global::broadcast_mask) == network::global::broadcast_mask) {
         network::Memset<0xFF, network::ethernet::kAddressLength>(out_buffer->ether.dst);
-        network::Memset<0xFF, network::ethernet::kAddressLength>(out_buffer->ip4.dst);
-    } else if ((remote_ip & network::global::broadcast_mask) == network::global::broadcast_mask) {
-        network::Memset<0xFF, network::ethernet::kAddressLength>(out_buffer->ether.dst);
-        network::MemcpyIp(out_buffer->ip4.dst, remote_ip);
     } else {
         if ((remote_ip & 0xF0) == 0xE0) { // Multicast, we know the MAC Address
             using _pcast32 = union pcast32 {
@@ -187,10 +234,11 @@ template <network::arp::EthSend S> static void SendImplementation(int index, con
             s_multicast_mac[5] = multicast_ip.u8[3];
 
             std::memcpy(out_buffer->ether.dst, s_multicast_mac, network::ethernet::kAddressLength);
-            network::MemcpyIp(out_buffer->ip4.dst, remote_ip);
         } else {
             if constexpr (S == network::arp::EthSend::kIsNormal) {
                 network::arp::Send(out_buffer, size + kUdpPacketHeadersSize, remote_ip);
+            } else if constexpr (S == network::arp::EthSend::kIsQueue) {
+                network::arp::SendQueue(out_buffer, size + kUdpPacketHeadersSize, remote_ip);
             }
 #if defined CONFIG_NET_ENABLE_PTP
             else if constexpr (S == network::arp::EthSend::kIsTimestamp) {
@@ -201,12 +249,10 @@ template <network::arp::EthSend S> static void SendImplementation(int index, con
         }
     }
 
-#if !defined(CHECKSUM_BY_HARDWARE)
-    out_buffer->ip4.chksum = network::Chksum(reinterpret_cast<void*>(&out_buffer->ip4), sizeof(out_buffer->ip4));
-#endif
-
     if constexpr (S == network::arp::EthSend::kIsNormal) {
         emac::eth::Send(size + kUdpPacketHeadersSize);
+    } else if constexpr (S == network::arp::EthSend::kIsQueue) {
+        emac::eth::SendQueue(size + kUdpPacketHeadersSize);
     }
 #if defined CONFIG_NET_ENABLE_PTP
     else if constexpr (S == network::arp::EthSend::kIsTimestamp) {
@@ -229,6 +275,8 @@ int32_t Begin(uint16_t localport, UdpCallbackFunctionPtr callback) {
             info.callback = callback;
             info.port = localport;
 
+            TemplateBuild(i);
+
             UDP_DEBUG_PRINTF("i=%d, localport=%d[%x], callback=%p", static_cast<int>(i), static_cast<unsigned>(localport), static_cast<unsigned>(localport), reinterpret_cast<void*>(callback));
             return i;
         }
@@ -262,6 +310,21 @@ void Send(int32_t index, const uint8_t* data, uint32_t size, uint32_t remote_ip,
     SendImplementation<network::arp::EthSend::kIsNormal>(index, data, size, remote_ip, remote_port);
 }
 
+/*
+ * Fills one TX descriptor per datagram and resumes the TxDMA once.
+ * A destination which is not in the ARP cache is queued until it is resolved.
+ */
+void SendBatch(int32_t index, const struct Datagram* datagrams, uint32_t count) {
+    assert(datagrams != nullptr);
+
+    for (uint32_t i = 0; i < count; i++) {
+        const auto& datagram = datagrams[i];
+        SendImplementation<network::arp::EthSend::kIsQueue>(index, datagram.data, datagram.size, datagram.remote_ip, datagram.remote_port);
+    }
+
+    emac::eth::SendFlush();
+}
+
 #if defined CONFIG_NET_ENABLE_PTP
 void SendWithTimestamp(int32_t index, const uint8_t* data, uint32_t size, uint32_t remote_ip, uint16_t remote_port) {
     SendImplementation<network::arp::EthSend::kIsTimestamp>(index, data, size, remote_ip, remote_port);
@@ -29,6 +29,7 @@
 
 #include "emac_counters.h"
 #include "emac/emac_phy.h"
+#include "emac/emac_link_check.h"
 #if defined(CONFIG_NET_ENABLE_PTP)
 #if !defined(DISABLE_RTC)
 #include "hwclock.h"
@@ -53,6 +54,49 @@ extern uint32_t sent;
 extern uint32_t received;
 } // namespace emac::eth::globals
 
+#if defined(CONFIG_SUPERLOOP_EVENT_DRIVEN)
+#include "superloop_event.h"
+#if defined(GD32H7XX)
+#if defined(USE_ENET0)
+#define ENET_EVENT_IRQn ENET0_IRQn
+#define ENET_EVENT_IRQ_HANDLER ENET0_IRQHandler
+#else
+#define ENET_EVENT_IRQn ENET1_IRQn
+#define ENET_EVENT_IRQ_HANDLER ENET1_IRQHandler
+#endif
+#else
+#define ENET_EVENT_IRQn ENET_IRQn
+#define ENET_EVENT_IRQ_HANDLER ENET_IRQHandler
+#endif
+
+// Wakes the superloop, the frames are still read by polling emac::eth::Recv()
+extern "C" void ENET_EVENT_IRQ_HANDLER() {
+#if defined(GD32H7XX)
+    enet_interrupt_flag_clear(ENETx, ENET_DMA_INT_FLAG_RS_CLR);
+    enet_interrupt_flag_clear(ENETx, ENET_DMA_INT_FLAG_NI_CLR);
+#else
+    enet_interrupt_flag_clear(ENET_DMA_INT_FLAG_RS_CLR);
+    enet_interrupt_flag_clear(ENET_DMA_INT_FLAG_NI_CLR);
+#endif
+    superloop::event::Set(superloop::event::kNetwork);
+}
+#endif
+
+#if defined(CHECKSUM_BY_HARDWARE)
+// Frames with a checksum error are passed on, emac::eth::Recv() counts and drops them
+static constexpr auto kRxChecksum = ENET_AUTOCHECKSUM_ACCEPT_FAILFRAMES;
+static constexpr uint32_t kTxChecksum = ENET_CHECKSUM_TCPUDPICMP_FULL;
+#else
+static constexpr auto kRxChecksum = ENET_NO_AUTOCHECKSUM;
+static constexpr uint32_t kTxChecksum = ENET_CHECKSUM_DISABLE;
+#endif
+
+#if defined(CONFIG_EMAC_HASH_MULTICAST_FILTER)
+static constexpr auto kRxFilter = ENET_BROADCAST_FRAMES_PASS; // Multicast filter is set by emac::multicast
+#else
+static constexpr auto kRxFilter = ENET_RECEIVEALL;
+#endif
+
 /*
  * Public function
  */
@@ -85,54 +129,45 @@ void __attribute__((cold)) Config() {
     EMAC_DEBUG_EXIT();
 }
 
+static enet_mediamode_enum MediaMode(emac::phy::Status phy_status) {
+    if (phy_status.speed == emac::phy::Speed::kSpeed100) {
+        if (phy_status.duplex == emac::phy::Duplex::kDuplexFull) {
+            return ENET_100M_FULLDUPLEX;
+        }
+        return ENET_100M_HALFDUPLEX;
+    }
+
+    if (phy_status.duplex == emac::phy::Duplex::kDuplexFull) {
+        return ENET_10M_FULLDUPLEX;
+    }
+
+    return ENET_10M_HALFDUPLEX;
+}
+
+/*
+ * Called when auto-negotiation has completed, the MAC is already running.
+ * Only the speed and duplex are changed, enet_init() would also reset the frame filter.
+ */
 void AdjustLink(emac::phy::Status phy_status) {
     EMAC_DEBUG_ENTRY();
 
     printf("Link %s, %d, %s\n", phy_status.link == emac::phy::Link::kStateUp ? "Up" : "Down", phy_status.speed == emac::phy::Speed::kSpeed10 ? 10 : 100, phy_status.duplex == emac::phy::Duplex::kDuplexHalf ? "HALF" : "FULL");
 
-#ifdef DEBUG_EMAC
-    {
-        uint16_t phy_value;
 #if defined(GD32H7XX)
-        ErrStatus phy_state = enet_phy_write_read(ENETx, ENET_PHY_READ, PHY_ADDRESS, PHY_REG_BCR, &phy_value);
+    auto mac_cfg = ENET_MAC_CFG(ENETx);
 #else
-        ErrStatus phy_state = enet_phy_write_read(ENET_PHY_READ, PHY_ADDRESS, PHY_REG_BCR, &phy_value);
-#endif
-        printf("BCR: %.4x %s\n", phy_value, phy_state == SUCCESS ? "SUCCES" : "ERROR");
-#if defined(GD32H7XX)
-        enet_phy_write_read(ENETx, ENET_PHY_READ, PHY_ADDRESS, PHY_REG_BSR, &phy_value);
-        phy_state = enet_phy_write_read(ENETx, ENET_PHY_READ, PHY_ADDRESS, PHY_REG_BSR, &phy_value);
-#else
-        enet_phy_write_read(ENET_PHY_READ, PHY_ADDRESS, PHY_REG_BSR, &phy_value);
-        phy_state = enet_phy_write_read(ENET_PHY_READ, PHY_ADDRESS, PHY_REG_BSR, &phy_value);
-#endif
-        printf("BSR: %.4x %s\n", phy_value & (PHY_AUTONEGO_COMPLETE | PHY_LINKED_STATUS | PHY_JABBER_DETECTION), phy_state == SUCCESS ? "SUCCES" : "ERROR");
-    }
+    auto mac_cfg = ENET_MAC_CFG;
 #endif
 
-    enet_mediamode_enum mediamode = ENET_10M_HALFDUPLEX;
-
-    if (phy_status.speed == emac::phy::Speed::kSpeed100) {
-        if (phy_status.duplex == emac::phy::Duplex::kDuplexFull) {
-            mediamode = ENET_100M_FULLDUPLEX;
-        } else {
-            mediamode = ENET_100M_HALFDUPLEX;
-        }
-    } else if (phy_status.duplex == emac::phy::Duplex::kDuplexFull) {
-        mediamode = ENET_10M_FULLDUPLEX;
-    }
+    mac_cfg &= ~(ENET_MAC_CFG_SPD | ENET_MAC_CFG_DPM);
+    mac_cfg |= static_cast<uint32_t>(MediaMode(phy_status));
 
 #if defined(GD32H7XX)
-    const auto kEnetInitStatus = enet_init(ENETx, mediamode, ENET_AUTOCHECKSUM_DROP_FAILFRAMES, ENET_RECEIVEALL);
+    ENET_MAC_CFG(ENETx) = mac_cfg;
 #else
-    const auto kEnetInitStatus = enet_init(mediamode, ENET_AUTOCHECKSUM_DROP_FAILFRAMES, ENET_RECEIVEALL);
+    ENET_MAC_CFG = mac_cfg;
 #endif
 
-    if (kEnetInitStatus != SUCCESS) {
-    }
-
-    EMAC_DEBUG_PRINTF("kEnetInitStatus=%s", kEnetInitStatus == SUCCESS ? "SUCCES" : "ERROR");
-
 #ifdef DEBUG_EMAC
     {
         uint16_t phy_value;
@@ -159,12 +194,26 @@ void __attribute__((cold)) Start(uint8_t mac_address[], emac::phy::Link& link) {
     EMAC_DEBUG_ENTRY();
     EMAC_DEBUG_PRINTF("ENET_RXBUF_NUM=%u, ENET_TXBUF_NUM=%u", ENET_RXBUF_NUM, ENET_TXBUF_NUM);
 
+    // Auto-negotiation takes 1-3 seconds, emac::link::Run() completes the link bring-up
     emac::phy::Status phy_status;
     emac::phy::Start(PHY_ADDRESS, phy_status);
 
     link = phy_status.link;
+    emac::link::Start(link);
+
+#if defined(GD32H7XX)
+    const auto kEnetInitStatus = enet_init(ENETx, MediaMode(phy_status), kRxChecksum, kRxFilter);
+#else
+    const auto kEnetInitStatus = enet_init(MediaMode(phy_status), kRxChecksum, kRxFilter);
+#endif
+
+    if (kEnetInitStatus != SUCCESS) {
+        network::Error(__func__, "enet_init");
+    }
 
-    AdjustLink(phy_status);
+    if (link == emac::phy::Link::kStateUp) {
+        AdjustLink(phy_status);
+    }
 
     MacAddress(mac_address);
 
@@ -189,7 +238,7 @@ void __attribute__((cold)) Start(uint8_t mac_address[], emac::phy::Link& link) {
 #endif
 
     for (uint32_t i = 0; i < ENET_TXBUF_NUM; i++) {
-        enet_transmit_checksum_config(&txdesc_tab[i], ENET_CHECKSUM_TCPUDPICMP_FULL);
+        enet_transmit_checksum_config(&txdesc_tab[i], kTxChecksum);
     }
 
 #if defined(CONFIG_NET_ENABLE_PTP)
@@ -200,6 +249,18 @@ void __attribute__((cold)) Start(uint8_t mac_address[], emac::phy::Link& link) {
 #endif
 #endif
 
+#if defined(CONFIG_SUPERLOOP_EVENT_DRIVEN)
+#if defined(GD32H7XX)
+    enet_interrupt_enable(ENETx, ENET_DMA_INT_NIE);
+    enet_interrupt_enable(ENETx, ENET_DMA_INT_RIE);
+#else
+    enet_interrupt_enable(ENET_DMA_INT_NIE);
+    enet_interrupt_enable(ENET_DMA_INT_RIE);
+#endif
+    NVIC_SetPriority(ENET_EVENT_IRQn, (1UL << __NVIC_PRIO_BITS) - 1UL); // Lowest priority
+    NVIC_EnableIRQ(ENET_EVENT_IRQn);
+#endif
+
     enet_enable(ENETx);
     
     memset(&emac::eth::globals::counter, 0, sizeof(emac::eth::globals::Counters));
@@ -59,8 +59,9 @@ void GetCounters(Counters& counters) {
     // Linux "fifo" / rx_over_errors / rx_fifo_errors semantic:
     // FIFO overflow / FIFO unable to accept/store frame.
     counters.rx.ovr = s_rx_fifo_drop_total;
-    // Optional: track CRC, length, descriptor errors, keep 0.
-    counters.rx.err = 0;
+    // Frames dropped by emac::eth::Recv(): checksum errors and truncated frames (DERR).
+    // The RxFIFO drops CRC and length errors before the descriptors.
+    counters.rx.err = emac::eth::globals::counter.receive_error;
 
     // Transmit
     counters.tx.ok = emac::eth::globals::counter.sent;
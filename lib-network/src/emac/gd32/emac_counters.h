@@ -13,6 +13,7 @@ struct Counters {
     uint32_t sent;
     uint32_t send_busy;
     uint32_t received;
+    uint32_t receive_error;
 };
 extern struct Counters counter;
 } // namespace emac::eth::globals
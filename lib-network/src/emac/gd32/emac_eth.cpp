@@ -38,8 +38,11 @@
 
 #include "gd32_enet.h"
 #include "../src/core/network_memcpy.h"
+#include "../src/core/network_private.h"
 #include "emac_counters.h"
+#include "network_stats.h"
 #include "firmware/debug/debug_dump.h"
+#include "firmware/debug/debug_timeline.h"
 #include "emac/emac_debug.h"
 #include "gd32.h" // IWYU pragma: keep
 
@@ -67,17 +70,54 @@ struct Counters counter;
 }
 
 // Receives an Ethernet packet.
+/*
+ * IPv4/IPv6 frame (FRMT) with an IP header or payload checksum error.
+ * The status of non-IP frames sets PCERR with FRMT cleared (checksum engine bypassed).
+ */
+static inline bool ChecksumError(uint32_t status) {
+    return ((status & ENET_RDES0_FRMT) != 0) && ((status & (ENET_RDES0_IPHERR | ENET_RDES0_PCERR)) != 0);
+}
+
+/*
+ * The RxFIFO drops frames with CRC, length or receive errors (FERF is off).
+ * Frames with only a checksum error (ENET_AUTOCHECKSUM_ACCEPT_FAILFRAMES) and
+ * frames truncated by the descriptor (DERR) do reach the RX ring, they are counted and dropped here.
+ */
+static inline bool ReceiveError(uint32_t status) {
+    if constexpr (network::checksum::kByHardware) {
+        if (ChecksumError(status)) {
+            return true;
+        }
+    }
+
+    return (status & ENET_RDES0_DERR) != 0;
+}
+
 uint32_t Recv(uint8_t** packet) {
-    const auto kLength = gd32::enet::DescInformationGet<RXDESC_FRAME_LENGTH>(dma_current_rxdesc);
+    auto length = gd32::enet::DescInformationGet<RXDESC_FRAME_LENGTH>(dma_current_rxdesc);
+
+    while ((length > 0) && ReceiveError(dma_current_rxdesc->status)) {
+        emac::eth::globals::counter.receive_error++;
+
+        if constexpr (network::checksum::kByHardware) {
+            if (ChecksumError(dma_current_rxdesc->status)) {
+                network::stats::Dropped(network::stats::Drop::kChecksum);
+            }
+        }
+
+        FreePkt();
+        length = gd32::enet::DescInformationGet<RXDESC_FRAME_LENGTH>(dma_current_rxdesc);
+    }
 
-    if (kLength > 0) {
+    if (length > 0) {
 #if defined(CONFIG_NET_ENABLE_PTP)
         *packet = reinterpret_cast<uint8_t*>(dma_current_ptp_rxdesc->buffer1_addr);
 #else
         *packet = reinterpret_cast<uint8_t*>(dma_current_rxdesc->buffer1_addr);
 #endif
         emac::eth::globals::counter.received++;
-        return kLength;
+        debug::timeline::Mark(debug::timeline::Id::kEmacRecv);
+        return length;
     }
 
     return 0;
@@ -164,6 +204,8 @@ uint8_t* SendGetDmaBuffer() {
  * @param length Length of the frame to transmit.
  */
 template <bool T> static void PtpFrameTransmit(uint32_t length) {
+    network::stats::Transmit(reinterpret_cast<uint8_t*>(dma_current_ptp_txdesc->buffer1_addr));
+
     dma_current_txdesc->control_buffer_size = length;              ///< Set the frame length
     dma_current_txdesc->status |= ENET_TDES0_LSG | ENET_TDES0_FSG; ///< Set the segment of frame, frame is transmitted in one descriptor
     dma_current_txdesc->status |= ENET_TDES0_DAV;                  ///< Enable DMA transmission
@@ -313,6 +355,17 @@ void SendTimestamp(void* buffer, uint32_t length) {
 
     PtpFrameTransmit<true>(buffer, length);
 }
+
+// The PTP descriptors are not batched.
+void SendQueue(uint32_t length) {
+    Send(length);
+}
+
+void SendQueue(void* buffer, uint32_t length) {
+    Send(buffer, length);
+}
+
+void SendFlush() {}
 #else
 /**
  * @brief Retrieves the DMA buffer for Ethernet transmission.
@@ -323,17 +376,25 @@ uint8_t* SendGetDmaBuffer() {
     // The descriptor is busy due to own by the DMA
     if (0 != (dma_current_txdesc->status & ENET_TDES0_DAV)) {
         emac::eth::globals::counter.send_busy++;
+#if defined(CONFIG_NET_ENABLE_STATS)
+        const auto kCycles = DWT->CYCCNT;
+#endif
+        gd32::enet::ClearDmaTxFlagsAndResume(); ///< Frames from SendQueue might not be handed over yet
         while (0 != (dma_current_txdesc->status & ENET_TDES0_DAV)) {
             __DMB(); ///< Wait until descriptor is available
         }
+#if defined(CONFIG_NET_ENABLE_STATS)
+        network::stats::TxWait(DWT->CYCCNT - kCycles);
+#endif
     }
 
     return reinterpret_cast<uint8_t*>(dma_current_txdesc->buffer1_addr);
 }
 
-// Transmits an Ethernet frame.
-void Send(uint32_t length) {
+// Hands an Ethernet frame to the DMA, the transmission is (re)started with SendFlush.
+void SendQueue(uint32_t length) {
     debug::Dump(reinterpret_cast<uint8_t*>(dma_current_txdesc->buffer1_addr), length);
+    network::stats::Transmit(reinterpret_cast<uint8_t*>(dma_current_txdesc->buffer1_addr));
 
     dma_current_txdesc->control_buffer_size = length;              ///< Set the frame length
     dma_current_txdesc->status |= ENET_TDES0_LSG | ENET_TDES0_FSG; ///< Set the segment of frame, frame is transmitted in one descriptor
@@ -343,8 +404,6 @@ void Send(uint32_t length) {
     __DMB();
 #endif
 
-    gd32::enet::ClearDmaTxFlagsAndResume(); ///< Handle transmission flags
-
     assert(0 != (dma_current_txdesc->status & ENET_TDES0_TCHM)); /// Chained mode
 
     /// Update the current TxDMA descriptor pointer to the next descriptor in TxDMA descriptor table
@@ -353,17 +412,37 @@ void Send(uint32_t length) {
     emac::eth::globals::counter.sent++;
 }
 
-// Transmits an Ethernet frame with data copying.
-void Send(void* buffer, uint32_t length) {
+// Resumes the TxDMA once for all frames handed over with SendQueue.
+void SendFlush() {
+    gd32::enet::ClearDmaTxFlagsAndResume(); ///< Handle transmission flags
+}
+
+// Transmits an Ethernet frame.
+void Send(uint32_t length) {
+    SendQueue(length);
+    SendFlush();
+}
+
+// Hands an Ethernet frame to the DMA with data copying, the transmission is (re)started with SendFlush.
+void SendQueue(void* buffer, uint32_t length) {
     EMAC_DEBUG_PRINTF("%p -> %u", buffer, static_cast<unsigned>(length));
 
     assert(nullptr != buffer);
     assert(length <= ENET_MAX_FRAME_SIZE);
 
     auto* dest = SendGetDmaBuffer();
-    std::memcpy(dest, buffer, length); ///< Copy frame to DMA buffer
 
-    Send(length);
+    if (dest != buffer) { ///< The UDP frames are built in the DMA buffer
+        std::memcpy(dest, buffer, length); ///< Copy frame to DMA buffer
+    }
+
+    SendQueue(length);
+}
+
+// Transmits an Ethernet frame with data copying.
+void Send(void* buffer, uint32_t length) {
+    SendQueue(buffer, length);
+    SendFlush();
 }
 #endif
 } // namespace emac::eth
\ No newline at end of file
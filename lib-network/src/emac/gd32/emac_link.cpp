@@ -37,6 +37,8 @@ void GpioInit() {
 #endif
 
 #if defined(ENET_LINK_CHECK_USE_INT)
+static volatile bool s_interrupt;
+
 void ExtiInit() {
     rcu_periph_clock_enable(LINK_CHECK_EXTI_CLK);
 
@@ -48,6 +50,18 @@ void ExtiInit() {
     exti_init(LINK_CHECK_EXTI_LINE, EXTI_INTERRUPT, EXTI_TRIG_FALLING);
     exti_interrupt_flag_clear(LINK_CHECK_EXTI_LINE);
 }
+
+/*
+ * The MDIO transactions and the netif link callbacks run here,
+ * outside interrupt context.
+ */
+void InterruptPoll() {
+    if (s_interrupt) {
+        s_interrupt = false;
+        PinRecovery();
+        HandleChange(StatusRead());
+    }
+}
 #endif
 
 #if defined(ENET_LINK_CHECK_USE_PIN_POLL)
@@ -66,8 +80,7 @@ extern "C" {
 void LINK_CHECK_IRQ_HANDLE() {
     if (RESET != exti_interrupt_flag_get(LINK_CHECK_EXTI_LINE)) {
         exti_interrupt_flag_clear(LINK_CHECK_EXTI_LINE);
-        emac::link::PinRecovery();
-        emac::link::HandleChange(emac::link::StatusRead());
+        emac::link::s_interrupt = true;
     }
 }
 }
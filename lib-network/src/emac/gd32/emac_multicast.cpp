@@ -27,6 +27,7 @@
 #include <cstddef>
 
 #include "gd32_enet.h"
+#include "core/ip4/igmp.h"
 #include "emac/emac_debug.h"
 #include "gd32.h" // IWYU pragma: keep
 
@@ -35,28 +36,52 @@ uint32_t Crc(const uint8_t* data, size_t length);
 }
 
 namespace emac::multicast {
+/*
+ * The first multicast addresses go into the perfect filters MAC address 1..3,
+ * the remaining ones into the 64-bit hash filter. A frame passes when it
+ * matches either of them.
+ */
+static constexpr enet_macaddress_enum kPerfect[] = {ENET_MAC_ADDRESS1, ENET_MAC_ADDRESS2, ENET_MAC_ADDRESS3};
+static uint32_t s_perfect_used;
 
-void EnableHashFilter() {
+void Enable() {
     EMAC_IGMP_DEBUG_ENTRY();
 
-    gd32::enet::ResetHash();
-    gd32::enet::FilterFeatureDisable<ENET_MULTICAST_FILTER_PASS>();
-    gd32::enet::FilterFeatureEnable<ENET_MULTICAST_FILTER_HASH_MODE>();
+    Reset();
+    gd32::enet::FilterFeatureDisable<ENET_RX_FILTER_DISABLE | ENET_MULTICAST_FILTER_PASS>();
+    gd32::enet::FilterFeatureEnable<ENET_MULTICAST_FILTER_HASH_OR_PERFECT>();
 
     EMAC_IGMP_DEBUG_EXIT();
 }
-void DisableHashFilter() {
+
+void Disable() {
     EMAC_IGMP_DEBUG_ENTRY();
 
-    gd32::enet::FilterFeatureDisable<ENET_MULTICAST_FILTER_HASH_MODE>();
-    gd32::enet::FilterFeatureEnable<ENET_MULTICAST_FILTER_PASS>();
+    gd32::enet::FilterFeatureDisable<ENET_MULTICAST_FILTER_HASH_OR_PERFECT>();
+    gd32::enet::FilterFeatureEnable<ENET_RX_FILTER_DISABLE | ENET_MULTICAST_FILTER_PASS>();
 
     EMAC_IGMP_DEBUG_EXIT();
 }
 
-void SetHash(const uint8_t* mac_addr) {
+void Add(const uint8_t* mac_addr) {
     EMAC_IGMP_DEBUG_ENTRY();
 
+    if (s_perfect_used < sizeof(kPerfect) / sizeof(kPerfect[0])) {
+        const auto kAddress = kPerfect[s_perfect_used++];
+#if defined(GD32H7XX)
+        enet_mac_address_set(ENETx, kAddress, const_cast<uint8_t*>(mac_addr));
+        enet_address_filter_config(ENETx, kAddress, 0, ENET_ADDRESS_FILTER_DA);
+        enet_address_filter_enable(ENETx, kAddress);
+#else
+        enet_mac_address_set(kAddress, const_cast<uint8_t*>(mac_addr));
+        enet_address_filter_config(kAddress, 0, ENET_ADDRESS_FILTER_DA);
+        enet_address_filter_enable(kAddress);
+#endif
+        EMAC_IGMP_DEBUG_PRINTF("MAC: " MACSTR " -> Perfect: %u", MAC2STR(mac_addr), static_cast<unsigned>(s_perfect_used));
+        EMAC_IGMP_DEBUG_EXIT();
+        return;
+    }
+
     const auto kCrc = network::Crc(mac_addr, 6);
     const auto kHash = (kCrc >> 26) & 0x3F;
 
@@ -66,11 +91,21 @@ void SetHash(const uint8_t* mac_addr) {
     EMAC_IGMP_DEBUG_EXIT();
 }
 
-void ResetHash() {
+void Reset() {
     EMAC_IGMP_DEBUG_ENTRY();
 
+    for (const auto kAddress : kPerfect) {
+#if defined(GD32H7XX)
+        enet_address_filter_disable(ENETx, kAddress);
+#else
+        enet_address_filter_disable(kAddress);
+#endif
+    }
+
+    s_perfect_used = 0;
+
     gd32::enet::ResetHash();
 
     EMAC_IGMP_DEBUG_EXIT();
 }
-} // namespace emac::multicast
\ No newline at end of file
+} // namespace emac::multicast
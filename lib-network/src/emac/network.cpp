@@ -24,6 +24,7 @@
  */
 
 #include <cstdio>
+#include <cstdlib> // IWYU pragma: keep // Needed for srandom())
 
 #include "emac/emac.h"
 #include "emac/emac_phy.h"
@@ -41,10 +42,17 @@
 #endif
 #include "network_event.h"
 #include "common/utils/utils_flags.h"
+#include "common/utils/utils_hash.h"
 #include "configstore.h"
 #include "apps/mdns.h"
 #include "network_store.h"
 #include "configurationstore.h"
+#include "timing.h"
+#include "network_stats.h"
+#if defined(CONFIG_NET_ENABLE_STATS) && defined(CONFIG_NET_STATS_PRINT_SECONDS)
+#include "softwaretimers.h"
+#endif
+#include "firmware/debug/debug_boottime.h"
 #include "firmware/debug/debug_debug.h"
 
 #ifdef DEBUG_NETWORK
@@ -67,10 +75,6 @@
     } while (false)
 #endif
 
-#if !defined(PHY_ADDRESS)
-#define PHY_ADDRESS 1
-#endif
-
 using common::store::network::Flags;
 
 namespace net {
@@ -94,6 +98,7 @@ static void NetifExtCallback(uint16_t reason, [[maybe_unused]] const netif::neti
 
     if ((reason & netif::NetifReason::kIpv4AddressChanged) == netif::NetifReason::kIpv4AddressChanged) {
         printf("ip: " IPSTR " -> " IPSTR "\n", IP2STR(args->ipv4_changed.old_address.addr), IP2STR(netif::IpAddr()));
+        debug::boottime::Mark("ip");
 
         network::event::Ipv4AddressChanged();
 #if defined(CONFIG_NET_ENABLE_NTP_CLIENT)
@@ -147,6 +152,9 @@ void Init() {
     emac::Start(netif::global::netif_default.hwaddr, global::link_state);
     printf(MACSTR "\n", MAC2STR(netif::global::netif_default.hwaddr));
 
+    // RFC 2131, 4.4.1 and RFC 5227, 2.1.1: seed the random delays with the MAC address
+    srandom(Fnv1a32Runtime(reinterpret_cast<const char*>(netif::global::netif_default.hwaddr), network::ethernet::kAddressLength));
+
     emac::display::Status(emac::phy::Link::kStateUp == global::link_state);
 
     network::arp::Init();
@@ -193,6 +201,11 @@ void Init() {
 
     network::Set(ipaddr, netmask, gw, !common::IsFlagSet(kFlags, Flags::Flag::kUseStaticIp));
 
+#if defined(CONFIG_NET_ENABLE_STATS) && defined(CONFIG_NET_STATS_PRINT_SECONDS)
+    // Periodic report on the console (UART0)
+    SoftwareTimerAdd(CONFIG_NET_STATS_PRINT_SECONDS * 1000U, []([[maybe_unused]] TimerHandle_t handle) { network::stats::Print(); });
+#endif
+
 #if defined(ENET_LINK_CHECK_USE_INT)
     emac::link::InterruptInit();
 #elif defined(ENET_LINK_CHECK_USE_PIN_POLL)
@@ -217,10 +230,19 @@ static void PrimaryIpConflictCallback(network::acd::Callback callback) {
             }
             network::dhcp::Inform();
             netif::SetFlags(netif::Netif::kNetifFlagStaticipOk);
+            printf("acd: " IPSTR " in use at %u ms\n", IP2STR(s_acd.ipaddr.addr), static_cast<unsigned>(timing::Millis()));
             break;
         case network::acd::Callback::kAcdRestartClient:
+            // Probe the static address again, the conflicting host may be gone
+            network::acd::Start(&s_acd, s_acd.ipaddr);
             break;
         case network::acd::Callback::kAcdDecline:
+            // With passive detection the address is already in use
+            if (netif.ip.addr == s_acd.ipaddr.addr) {
+                network::ip4_addr_t any;
+                any.addr = 0;
+                netif::SetIpAddr(any);
+            }
             netif::ClearFlags(netif::Netif::kNetifFlagStaticipOk);
             break;
         default:
@@ -243,14 +265,15 @@ void Set(network::ip4_addr_t ipaddr, network::ip4_addr_t netmask, network::ip4_a
         }
     }
 
-    if (emac::phy::Link::kStateUp == emac::phy::GetLink(PHY_ADDRESS)) {
+    // Maintained by emac::link, the link is only up once auto-negotiation has completed
+    if (emac::phy::Link::kStateUp == global::link_state) {
         netif::SetFlags(netif::Netif::kNetifFlagLinkUp);
     } else {
         netif::ClearFlags(netif::Netif::kNetifFlagLinkUp);
     }
 
     if (use_dhcp) {
-        network::dhcp::Start();
+        network::dhcp::Start(ConfigStore::Instance().NetworkGet(&common::store::Network::dhcp_lease_ip));
     } else {
         if (ipaddr.addr == 0) {
             network::acd::Start(&s_acd, netif::global::netif_default.secondary_ip);
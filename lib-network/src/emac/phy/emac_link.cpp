@@ -23,11 +23,13 @@
  * THE SOFTWARE.
  */
 
+#include <cstdint>
+
 #include "core/netif.h"
 #include "emac/emac_link_check.h"
 #include "emac/emac_phy.h"
 #include "emac/emac.h"
-#include "watchdog.h" // IWYU pragma: keep
+#include "timing.h"
 #include "emac/emac_debug.h"
 
 static constexpr uint16_t kAddress =
@@ -37,7 +39,20 @@ static constexpr uint16_t kAddress =
     PHY_ADDRESS;
 #endif
 
+namespace network::global {
+extern emac::phy::Link link_state;
+} // namespace network::global
+
 namespace emac::link {
+// MDIO poll interval while waiting for auto-negotiation, and for ENET_LINK_CHECK_REG_POLL
+static constexpr uint32_t kPollMillis = 20;
+
+enum class State : uint8_t { kAutonegotiation, kUp };
+
+static State s_state;
+static uint32_t s_millis_poll;
+static uint32_t s_millis_start;
+
 #if defined(ENET_LINK_CHECK_USE_INT)
 void InterruptInit() {
     link::PinEnable();
@@ -59,29 +74,83 @@ emac::phy::Link StatusRead() {
     return emac::phy::GetLink(kAddress);
 }
 
+static void LinkUp(const phy::Status& phy_status) {
+    EMAC_PHY_DEBUG_PRINTF("%u ms", static_cast<unsigned>(timing::Millis() - s_millis_start));
+
+    s_state = State::kUp;
+    network::global::link_state = phy::Link::kStateUp;
+
+    emac::AdjustLink(phy_status);
+
+    netif::SetLinkUp();
+}
+
+void Start(emac::phy::Link link) {
+    s_millis_start = timing::Millis();
+    s_millis_poll = s_millis_start;
+    s_state = (link == phy::Link::kStateUp) ? State::kUp : State::kAutonegotiation;
+}
+
+void Run() {
+#if defined(ENET_LINK_CHECK_USE_INT)
+    link::InterruptPoll();
+#elif defined(ENET_LINK_CHECK_USE_PIN_POLL)
+    link::PinPoll();
+#endif
+
+#if !defined(ENET_LINK_CHECK_REG_POLL)
+    if (s_state == State::kUp) {
+        return;
+    }
+#endif
+
+    const auto kMillis = timing::Millis();
+
+    if ((kMillis - s_millis_poll) < kPollMillis) {
+        return;
+    }
+
+    s_millis_poll = kMillis;
+
+#if defined(ENET_LINK_CHECK_REG_POLL)
+    if (s_state == State::kUp) {
+        if (StatusRead() == phy::Link::kStateDown) {
+            HandleChange(phy::Link::kStateDown);
+        }
+        return;
+    }
+#endif
+
+    phy::Status phy_status;
+
+    if (phy::GetStatus(kAddress, phy_status) && (phy_status.link == phy::Link::kStateUp)) {
+        LinkUp(phy_status);
+    }
+}
+
 void HandleChange(emac::phy::Link state) {
     EMAC_PHY_DEBUG_PRINTF("emac::phy::Link %s", state == emac::phy::Link::kStateUp ? "UP" : "DOWN");
 
     if (phy::Link::kStateUp == state) {
-        const auto kIsWatchdog = watchdog::Watchdog();
-
-        if (kIsWatchdog) {
-            watchdog::Stop();
+        if (s_state == State::kUp) {
+            return;
         }
 
         phy::Status phy_status;
         phy::Start(kAddress, phy_status);
 
-        emac::AdjustLink(phy_status);
+        link::Start(phy_status.link);
 
-        if (kIsWatchdog) {
-            watchdog::Init();
+        if (phy_status.link == phy::Link::kStateUp) {
+            LinkUp(phy_status);
         }
-
-        netif::SetLinkUp();
         return;
     }
 
+    // The PHY restarts auto-negotiation by itself, Run() waits for it
+    link::Start(phy::Link::kStateDown);
+    network::global::link_state = phy::Link::kStateDown;
+
     netif::SetLinkDown();
 }
 } // namespace emac::link
@@ -27,7 +27,6 @@
 
 #include "emac/emac_phy.h"
 #include "emac/mmi.h"
-#include "timing.h"
 #include "emac/emac_debug.h"
 #include "firmware/debug/debug_printbits.h" // IWYU pragma: keep
 
@@ -145,50 +144,6 @@ static bool ConfigAutonegotiation(uint16_t address, uint16_t advertisement) {
     return true;
 }
 
-static bool UpdateLink(uint16_t address, Status& phy_status) {
-    EMAC_PHY_DEBUG_ENTRY();
-
-    uint16_t bmsr;
-
-    if (!phy::Read(address, mmi::REG_BMSR, bmsr)) {
-        EMAC_PHY_DEBUG_EXIT();
-        return false;
-    }
-
-    // If we already saw the link up, and it hasn't gone down, then
-    // we don't need to wait for autoneg again
-    if ((phy_status.link == Link::kStateDown) && (bmsr & mmi::BMSR_LINKED_STATUS)) {
-        EMAC_PHY_DEBUG_EXIT();
-        return true;
-    }
-
-    if (!(bmsr & mmi::BMSR_AUTONEGO_COMPLETE)) {
-        puts("Waiting for PHY auto negotiation to complete");
-
-        const auto kMillis = timing::Millis();
-        while (!(bmsr & mmi::BMSR_AUTONEGO_COMPLETE)) {
-            if ((timing::Millis() - kMillis) > 5000) {
-                EMAC_PHY_DEBUG_EXIT();
-                return false;
-            }
-            phy::Read(address, mmi::REG_BMSR, bmsr);
-        }
-
-        phy_status.link = Link::kStateUp;
-
-        EMAC_PHY_DEBUG_PRINTF("%u", static_cast<unsigned>(timing::Millis() - kMillis));
-        EMAC_PHY_DEBUG_EXIT();
-        return true;
-    }
-
-    // This path is only reached if autonegotiation is complete
-    phy::Read(address, mmi::REG_BMSR, bmsr);
-    phy_status.link = bmsr & mmi::BMSR_LINKED_STATUS ? Link::kStateUp : Link::kStateDown;
-
-    EMAC_PHY_DEBUG_EXIT();
-    return true;
-}
-
 static void ParseLink(uint16_t address, Status& phy_status) {
     if (phy_status.link != Link::kStateUp) {
         phy_status.duplex = Duplex::kUnknown;
@@ -227,6 +182,32 @@ static void ParseLink(uint16_t address, Status& phy_status) {
     }
 }
 
+bool GetStatus(uint16_t address, Status& phy_status) {
+    uint16_t bmcr;
+
+    if (!phy::Read(address, mmi::REG_BMCR, bmcr)) {
+        return false;
+    }
+
+    uint16_t bmsr;
+
+    phy::Read(address, mmi::REG_BMSR, bmsr); // clear latch
+
+    if (!phy::Read(address, mmi::REG_BMSR, bmsr)) {
+        return false;
+    }
+
+    phy_status.autonegotiation = (bmcr & mmi::BMCR_AUTONEGOTIATION);
+
+    const auto kIsComplete = !phy_status.autonegotiation || (bmsr & mmi::BMSR_AUTONEGO_COMPLETE);
+
+    phy_status.link = (kIsComplete && (bmsr & mmi::BMSR_LINKED_STATUS)) ? Link::kStateUp : Link::kStateDown;
+
+    ParseLink(address, phy_status);
+
+    return true;
+}
+
 bool Start(uint16_t address, Status& phy_status) {
     EMAC_PHY_DEBUG_ENTRY();
 
@@ -239,25 +220,11 @@ bool Start(uint16_t address, Status& phy_status) {
         return false;
     }
 
-    if (!UpdateLink(address, phy_status)) {
+    if (!GetStatus(address, phy_status)) {
         EMAC_PHY_DEBUG_EXIT();
         return false;
     }
 
-    uint16_t bmcr;
-    phy::Read(address, mmi::REG_BMCR, bmcr);
-
-    phy_status.autonegotiation = (bmcr & mmi::BMCR_AUTONEGOTIATION);
-
-    phy_status.link = phy::GetLink(address);
-
-    if (phy_status.link == Link::kStateUp) {
-        ParseLink(address, phy_status);
-    } else {
-        phy_status.speed = Speed::kUnknown;
-        phy_status.duplex = Duplex::kUnknown;
-    }
-
     EMAC_PHY_DEBUG_PRINTF("Link %s, %s, %s", ToString(phy_status.link), ToString(phy_status.speed), ToString(phy_status.duplex));
     EMAC_PHY_DEBUG_EXIT();
     return true;
@@ -0,0 +1,58 @@
+/**
+ * @file emac_link.cpp
+ *
+ */
+/* Copyright (C) 2026 by Arjan van Vught mailto:info@gd32-dmx.org
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <cstdint>
+
+#include "emac/emac_link_check.h"
+#include "emac/emac_phy.h"
+#include "emac/mmi.h"
+
+#if !defined(PHY_ADDRESS)
+#define PHY_ADDRESS 1
+#endif
+
+// Interrupt Source Flag Register, cleared on read
+#define PHY_REG_ISFR 0x1DU
+// Interrupt Mask Register
+#define PHY_REG_IMR 0x1EU
+#define INT_LINK_DOWN (1U << 4)
+#define INT_AUTONEGO_COMPLETE (1U << 6)
+
+namespace emac::link {
+#if defined(ENET_LINK_CHECK_USE_INT) || defined(ENET_LINK_CHECK_USE_PIN_POLL)
+void PinEnable() {
+    phy::Write(PHY_ADDRESS, PHY_REG_IMR, INT_LINK_DOWN | INT_AUTONEGO_COMPLETE);
+    // Clear interrupt
+    uint16_t phy_value;
+    phy::Read(PHY_ADDRESS, PHY_REG_ISFR, phy_value);
+}
+
+void PinRecovery() {
+    uint16_t phy_value;
+    phy::Read(PHY_ADDRESS, PHY_REG_ISFR, phy_value);
+    phy::Read(PHY_ADDRESS, mmi::REG_BMSR, phy_value);
+}
+#endif
+} // namespace emac::link
@@ -39,6 +39,10 @@
 #define PHY_ADDRESS 1
 #endif
 
+#if defined(ENET_LINK_CHECK_USE_INT) || defined(ENET_LINK_CHECK_USE_PIN_POLL)
+#error The generic PHY has no interrupt output, use ENET_LINK_CHECK_REG_POLL
+#endif
+
 namespace emac::phy {
 void CustomizedLed() {
     EMAC_PHY_DEBUG_ENTRY();
@@ -35,6 +35,7 @@
 #include "core/ip4/arp.h"
 #include "core/protocol/ieee.h"
 #include "core/protocol/ethernet.h"
+#include "network_stats.h"
 #include "iface_debug.h"
 
 namespace network {
@@ -52,6 +53,8 @@ namespace iface {
 void EthernetInput(const uint8_t* buffer, [[maybe_unused]] uint32_t length) {
     const auto* const kEther = reinterpret_cast<const struct network::ethernet::Header*>(buffer);
 
+    network::stats::Receive(buffer);
+
     switch (kEther->type) {
 #if defined(CONFIG_NET_ENABLE_PTP)
         case __builtin_bswap16(network::ethernet::Type::kPtp):
@@ -65,6 +68,7 @@ void EthernetInput(const uint8_t* buffer, [[maybe_unused]] uint32_t length) {
 
             if ((kEther->dst[0] == network::ethernet::kIP4MulticastAddr0) && (kEther->dst[1] == network::ethernet::kIP4MulticastAddr1) && (kEther->dst[2] == network::ethernet::kIP4MulticastAddr2)) {
                 if (!network::igmp::LookupGroup(network::MemcpyIp(kIp4->ip4.dst))) {
+                    network::stats::Dropped(network::stats::Drop::kMulticast);
                     emac::eth::FreePkt();
                     DEBUG_PUTS("IGMP not for us");
                     return;
@@ -64,4 +64,9 @@ __attribute__((weak)) void SaveDhcp(bool is_dhcp_used)
 
     ConfigStore::Instance().NetworkUpdate(&common::store::Network::flags, flags);
 }
+
+__attribute__((weak)) void SaveDhcpLease(uint32_t ip)
+{
+    ConfigStore::Instance().NetworkUpdate(&common::store::Network::dhcp_lease_ip, ip);
+}
 } // namespace network::store
\ No newline at end of file
@@ -36,6 +36,7 @@
 #endif
 #include "network.h"
 #include "configstore.h"
+#include "softwaretimers.h"
 
 #ifdef DEBUG_REMOTECONFIG
 #define REMOTECONFIG_DEBUG_ENTRY() DEBUG_ENTRY()
@@ -103,12 +104,23 @@ class RemoteConfig {
     static RemoteConfig* Get() { return s_this; }
 
    private:
+    void Dispatch();
+    void HandleBatch();
+    void HandleWait();
+    bool WaitPoll();
+    void Reply(const char* data, uint32_t length);
+    void ReplyStatus(bool is_ok);
     void HandleRequest();
     void HandleReboot();
     void HandleFactory();
     void HandleList();
 #if !defined(CONFIG_REMOTECONFIG_MINIMUM)
     void HandleUptime();
+    void HandleNetStats();
+#endif
+    void HandleBootTime();
+#if defined(CONFIG_DEBUG_TIMELINE)
+    void HandleTimeline();
 #endif
     void HandleVersion();
 
@@ -127,6 +139,12 @@ class RemoteConfig {
     int32_t handle_{-1};
     uint32_t ip_from_{0};
     uint32_t bytes_received_{0};
+    uint32_t buffer_size_{remoteconfig::udp::kBufferSize};
+
+    // Set while the replies are collected, for a batch or a wait
+    char* reply_{nullptr};
+    uint32_t reply_size_{0};
+    uint32_t reply_length_{0};
 
     struct Commands {
         void (RemoteConfig::*handler)();
@@ -138,6 +156,8 @@ class RemoteConfig {
     static const Commands kGet[];
     static const Commands kSet[];
 
+    static const Commands* Find(bool is_get, const char* request, uint32_t length);
+
     struct List {
         uint8_t mac_address[network::iface::kMacSize];
         uint8_t output;
@@ -156,6 +176,7 @@ class RemoteConfig {
 #endif
 
     void static StaticCallbackFunction(const uint8_t* buffer, uint32_t size, uint32_t from_ip, uint16_t from_port) { RemoteConfig::Get()->Input(buffer, size, from_ip, from_port); }
+    void static StaticWaitTimer(TimerHandle_t timer_handle);
 
     static inline List s_list;
     static inline RemoteConfig* s_this;
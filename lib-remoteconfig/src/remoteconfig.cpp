@@ -31,14 +31,22 @@
 
 #include "remoteconfig.h"
 #include "firmware/firmwareversion.h"
+#include "firmware/debug/debug_boottime.h"
+#include "firmware/debug/debug_timeline.h"
 #include "timing.h"
 #include "network_udp.h"
+#include "network_stats.h"
 #if !defined(CONFIG_REMOTECONFIG_MINIMUM)
 #include "apps/mdns.h"
 #include "dmxnode_nodetype.h"
 #include "json/remoteconfigparams.h"
 #endif
 #include "common/utils/utils_array.h"
+#include "common/utils/utils_format.h"
+#include "common/utils/utils_hash.h"
+#if defined(ENABLE_HTTPD) && !defined(CONFIG_REMOTECONFIG_MINIMUM)
+#include "common/utils/utils_inplace.h"
+#endif
 #include "display.h"
 #include "configstore.h"
 
@@ -51,27 +59,56 @@ enum class Command {
     kVersion, //
     kDisplay, //
 #if !defined(CONFIG_REMOTECONFIG_MINIMUM)
-    kUptime, //
+    kUptime,   //
+    kNetStats, //
+#endif
+    kBootTime, //
+#if defined(CONFIG_DEBUG_TIMELINE)
+    kTimeline, //
 #endif
-    kTftp,   //
-    kFactory //
+    kTftp,    //
+    kFactory, //
+    kWait     //
 };
 } // namespace get
 namespace set {
 enum class Command { kTftp, kDisplay };
 } // namespace set
+static constexpr uint32_t kBatchMinimum = 128; // Space left for the next command of a batch
+static constexpr uint32_t kWaitPollMillis = 20;
+static constexpr uint32_t kWaitMillisMax = 60000;
 } // namespace remoteconfig::udp
 
+static struct Wait {
+    TimerHandle_t timer_id{kTimerIdNone};
+    uint32_t ip;
+    uint32_t deadline;
+    uint32_t expected_length;
+    uint32_t command_index;
+    char expected[32];
+    char reply[96];
+} s_wait;
+
+#if defined(ENABLE_HTTPD) && !defined(CONFIG_REMOTECONFIG_MINIMUM)
+static common::InPlace<HttpDaemon> s_http_daemon;
+#endif
+
 constexpr struct RemoteConfig::Commands RemoteConfig::kGet[] = {
     {&RemoteConfig::HandleReboot, "reboot##", 8, false},     //
     {&RemoteConfig::HandleList, "list#", 5, false},          //
     {&RemoteConfig::HandleVersion, "version#", 8, false},    //
     {&RemoteConfig::HandleDisplayGet, "display#", 8, false}, //
 #if !defined(CONFIG_REMOTECONFIG_MINIMUM)
-    {&RemoteConfig::HandleUptime, "uptime#", 7, false}, //
+    {&RemoteConfig::HandleUptime, "uptime#", 7, false},     //
+    {&RemoteConfig::HandleNetStats, "netstats#", 9, false}, //
+#endif
+    {&RemoteConfig::HandleBootTime, "boottime#", 9, false}, //
+#if defined(CONFIG_DEBUG_TIMELINE)
+    {&RemoteConfig::HandleTimeline, "timeline#", 9, false}, //
 #endif
     {&RemoteConfig::HandleTftpGet, "tftp#", 5, false},    //
-    {&RemoteConfig::HandleFactory, "factory##", 9, false} //
+    {&RemoteConfig::HandleFactory, "factory##", 9, false}, //
+    {&RemoteConfig::HandleWait, "wait#", 5, true}          //
 };
 
 constexpr struct RemoteConfig::Commands RemoteConfig::kSet[] = {
@@ -104,8 +141,7 @@ RemoteConfig::RemoteConfig(remoteconfig::Output output, uint32_t active_outputs)
 #endif
 
 #if defined(ENABLE_HTTPD)
-    http_daemon_ = new HttpDaemon;
-    assert(http_daemon_ != nullptr);
+    http_daemon_ = s_http_daemon.Emplace();
 #endif
 #endif
 
@@ -120,11 +156,14 @@ RemoteConfig::RemoteConfig(remoteconfig::Output output, uint32_t active_outputs)
 RemoteConfig::~RemoteConfig() {
     REMOTECONFIG_DEBUG_ENTRY();
 
+    if (s_wait.timer_id != kTimerIdNone) {
+        SoftwareTimerDelete(s_wait.timer_id);
+    }
+
 #if !defined(CONFIG_REMOTECONFIG_MINIMUM)
 #if defined(ENABLE_HTTPD)
-
-    delete http_daemon_;
-
+    s_http_daemon.Reset();
+    http_daemon_ = nullptr;
 #endif
     network::apps::mdns::ServiceRecordDelete(network::apps::mdns::Services::kConfig);
 #endif
@@ -165,6 +204,7 @@ void RemoteConfig::HandleFactory() {
 void RemoteConfig::Input(const uint8_t* buffer, uint32_t size, uint32_t from_ip, [[maybe_unused]] uint16_t from_port) {
     udp_buffer_ = const_cast<char*>(reinterpret_cast<const char*>(buffer));
     bytes_received_ = size;
+    buffer_size_ = remoteconfig::udp::kBufferSize;
     ip_from_ = from_ip;
 #ifndef NDEBUG
     debug::Dump(udp_buffer_, bytes_received_);
@@ -174,55 +214,239 @@ void RemoteConfig::Input(const uint8_t* buffer, uint32_t size, uint32_t from_ip,
         bytes_received_--;
     }
 
-    const Commands* handler = nullptr;
+    if (udp_buffer_[0] == '*') {
+        HandleBatch();
+        return;
+    }
+
+    Dispatch();
+}
+
+const RemoteConfig::Commands* RemoteConfig::Find(bool is_get, const char* request, uint32_t length) {
+    static constexpr auto kGetHash = common::hash::MakePerfectHash<'#'>(kGet, &Commands::cmd);
+    static constexpr auto kSetHash = common::hash::MakePerfectHash<'#'>(kSet, &Commands::cmd);
+
+    if (is_get) {
+        const auto kIndex = kGetHash.Find(request, length);
+        return (kIndex < (sizeof(kGet) / sizeof(kGet[0]))) ? &kGet[kIndex] : nullptr;
+    }
+
+    const auto kIndex = kSetHash.Find(request, length);
+    return (kIndex < (sizeof(kSet) / sizeof(kSet[0]))) ? &kSet[kIndex] : nullptr;
+}
 
+void RemoteConfig::Dispatch() {
     if (udp_buffer_[0] == '?') {
         bytes_received_--;
-        for (uint32_t i = 0; i < (sizeof(kGet) / sizeof(kGet[0])); i++) {
-            if ((kGet[i].kGreaterThan) && (bytes_received_ <= kGet[i].kLength)) {
-                continue;
-            }
-            if ((!kGet[i].kGreaterThan) && (bytes_received_ != kGet[i].kLength)) {
-                continue;
-            }
-            if (memcmp(&udp_buffer_[1], kGet[i].cmd, kGet[i].kLength) == 0) {
-                handler = &kGet[i];
-                break;
-            }
-        }
 
-        if (handler != nullptr) {
-            (this->*(handler->handler))();
-            return;
+        const auto* command = Find(true, &udp_buffer_[1], bytes_received_);
+
+        if (command != nullptr) {
+            const auto kIsLength = command->kGreaterThan ? (bytes_received_ > command->kLength) : (bytes_received_ == command->kLength);
+            if (kIsLength && (memcmp(&udp_buffer_[1], command->cmd, command->kLength) == 0)) {
+                (this->*(command->handler))();
+                return;
+            }
         }
 
-        network::udp::Send(handle_, reinterpret_cast<const uint8_t*>("ERROR#?\n"), 8, ip_from_, remoteconfig::udp::kPort);
+        Reply("ERROR#?\n", 8);
         return;
     }
 
     if (udp_buffer_[0] == '!') {
         bytes_received_--;
-        for (uint32_t i = 0; i < (sizeof(kSet) / sizeof(kSet[0])); i++) {
-            if ((kSet[i].kGreaterThan) && (bytes_received_ <= kSet[i].kLength)) {
-                continue;
-            }
-            if ((!kSet[i].kGreaterThan) && ((bytes_received_ - 1U) != kSet[i].kLength)) {
-                continue;
+
+        const auto* command = Find(false, &udp_buffer_[1], bytes_received_);
+
+        if (command != nullptr) {
+            const auto kIsLength = command->kGreaterThan ? (bytes_received_ > command->kLength) : ((bytes_received_ - 1U) == command->kLength);
+            if (kIsLength && (memcmp(&udp_buffer_[1], command->cmd, command->kLength) == 0)) {
+                (this->*(command->handler))();
+                return;
             }
-            if (memcmp(&udp_buffer_[1], kSet[i].cmd, kSet[i].kLength) == 0) {
-                handler = &kSet[i];
+        }
+
+        Reply("ERROR#!\n", 8);
+        return;
+    }
+
+    ReplyStatus(false);
+}
+
+void RemoteConfig::Reply(const char* data, uint32_t length) {
+    if (reply_ == nullptr) {
+        network::udp::Send(handle_, reinterpret_cast<const uint8_t*>(data), length, ip_from_, remoteconfig::udp::kPort);
+        return;
+    }
+
+    length = std::min(length, reply_size_ - reply_length_);
+    memmove(&reply_[reply_length_], data, length);
+    reply_length_ += length;
+}
+
+// A set command has no reply, in a batch it has a status
+void RemoteConfig::ReplyStatus(bool is_ok) {
+    if (reply_ != nullptr) {
+        Reply(is_ok ? "OK\n" : "ERROR\n", is_ok ? 3 : 6);
+    }
+}
+
+/*
+ * *<command>\n<command>\n...
+ * The commands are executed in order and the replies are sent in one datagram.
+ * The requests are moved to the end of the buffer, the replies grow from the
+ * start and a command works in the space in between. When that space is too
+ * small, the remaining commands are not executed. A reboot does not reply.
+ */
+void RemoteConfig::HandleBatch() {
+    REMOTECONFIG_DEBUG_ENTRY();
+
+    auto* buffer = udp_buffer_;
+    const auto kRequestsLength = bytes_received_ - 1U;
+    auto* requests = &buffer[remoteconfig::udp::kBufferSize - kRequestsLength];
+    const auto* requests_end = &buffer[remoteconfig::udp::kBufferSize];
+
+    memmove(requests, &buffer[1], kRequestsLength);
+
+    reply_ = buffer;
+    reply_length_ = 0;
+
+    while (requests < requests_end) {
+        auto* end = requests;
+        while ((end < requests_end) && (*end != '\n')) {
+            end++;
+        }
+
+        const auto kLength = static_cast<uint32_t>(end - requests);
+        auto* next = (end < requests_end) ? end + 1 : end;
+
+        if (kLength != 0) {
+            udp_buffer_ = &buffer[reply_length_];
+            buffer_size_ = static_cast<uint32_t>(next - udp_buffer_);
+
+            if (buffer_size_ < remoteconfig::udp::kBatchMinimum) {
                 break;
             }
-        }
 
-        if (handler != nullptr) {
-            (this->*(handler->handler))();
-            return;
+            reply_size_ = static_cast<uint32_t>(next - buffer);
+            memmove(udp_buffer_, requests, kLength);
+            bytes_received_ = kLength;
+
+            Dispatch();
         }
 
-        network::udp::Send(handle_, reinterpret_cast<const uint8_t*>("ERROR#!\n"), 8, ip_from_, remoteconfig::udp::kPort);
+        requests = next;
+    }
+
+    reply_ = nullptr;
+    udp_buffer_ = buffer;
+    buffer_size_ = remoteconfig::udp::kBufferSize;
+
+    if (reply_length_ != 0) {
+        network::udp::Send(handle_, reinterpret_cast<const uint8_t*>(buffer), reply_length_, ip_from_, remoteconfig::udp::kPort);
+    }
+
+    REMOTECONFIG_DEBUG_EXIT();
+}
+
+/*
+ * ?wait#<timeout ms>#<name>:<value>
+ * Replies when the reply of ?<name># is <name>:<value>, or with the reply at
+ * the timeout. The state is polled by a software timer, so the superloop keeps
+ * running. One wait at a time, a new wait is refused while one is pending.
+ */
+void RemoteConfig::HandleWait() {
+    REMOTECONFIG_DEBUG_ENTRY();
+
+    constexpr auto kCmdLength = kGet[static_cast<uint32_t>(remoteconfig::udp::get::Command::kWait)].kLength;
+
+    const auto* request = &udp_buffer_[kCmdLength + 1U];
+    const auto* request_end = &udp_buffer_[bytes_received_ + 1U];
+
+    uint32_t timeout = 0;
+
+    while ((request < request_end) && (*request >= '0') && (*request <= '9')) {
+        timeout = std::min(timeout * 10U + static_cast<uint32_t>(*request - '0'), remoteconfig::udp::kWaitMillisMax);
+        request++;
+    }
+
+    const auto* name = request + 1;
+    const auto* colon = name;
+
+    while ((colon < request_end) && (*colon != ':')) {
+        colon++;
+    }
+
+    const auto kNameLength = static_cast<uint32_t>(colon - name);
+    const auto kExpectedLength = static_cast<uint32_t>(request_end - name);
+    const auto* command = (request < request_end) && (*request == '#') ? Find(true, name, kNameLength) : nullptr;
+
+    // A plain ?<name># command, not in a batch and no wait pending
+    if ((reply_ != nullptr) || (s_wait.timer_id != kTimerIdNone) || (command == nullptr) || (colon == request_end) || command->kGreaterThan || (command->kLength != (kNameLength + 1U)) || (memcmp(command->cmd, name, kNameLength) != 0) ||
+        (kExpectedLength > sizeof(s_wait.expected))
+#if defined(CONFIG_DEBUG_TIMELINE)
+        || (command->handler == &RemoteConfig::HandleTimeline)
+#endif
+    ) {
+        Reply("ERROR#?\n", 8);
+        REMOTECONFIG_DEBUG_EXIT();
         return;
     }
+
+    s_wait.ip = ip_from_;
+    s_wait.deadline = timing::Millis() + timeout;
+    s_wait.command_index = static_cast<uint32_t>(command - kGet);
+    s_wait.expected_length = kExpectedLength;
+    memcpy(s_wait.expected, name, kExpectedLength);
+
+    if (!WaitPoll()) {
+        s_wait.timer_id = SoftwareTimerAdd(remoteconfig::udp::kWaitPollMillis, StaticWaitTimer);
+
+        if (s_wait.timer_id == kTimerIdNone) {
+            s_wait.deadline = timing::Millis();
+            WaitPoll();
+        }
+    }
+
+    REMOTECONFIG_DEBUG_EXIT();
+}
+
+// Returns true when the reply is sent
+bool RemoteConfig::WaitPoll() {
+    const auto& command = kGet[s_wait.command_index];
+
+    udp_buffer_ = s_wait.reply;
+    buffer_size_ = sizeof(s_wait.reply);
+    bytes_received_ = command.kLength;
+    reply_ = s_wait.reply;
+    reply_size_ = sizeof(s_wait.reply);
+    reply_length_ = 0;
+
+    (this->*(command.handler))();
+
+    reply_ = nullptr;
+
+    auto length = reply_length_;
+
+    if ((length != 0) && (s_wait.reply[length - 1] == '\n')) {
+        length--;
+    }
+
+    const auto kIsMatch = (length == s_wait.expected_length) && (memcmp(s_wait.reply, s_wait.expected, length) == 0);
+    const auto kIsTimeout = static_cast<int32_t>(timing::Millis() - s_wait.deadline) >= 0;
+
+    if (!kIsMatch && !kIsTimeout) {
+        return false;
+    }
+
+    network::udp::Send(handle_, reinterpret_cast<const uint8_t*>(s_wait.reply), reply_length_, s_wait.ip, remoteconfig::udp::kPort);
+    return true;
+}
+
+void RemoteConfig::StaticWaitTimer([[maybe_unused]] TimerHandle_t timer_handle) {
+    if (RemoteConfig::Get()->WaitPoll()) {
+        SoftwareTimerDelete(s_wait.timer_id);
+    }
 }
 
 #if !defined(CONFIG_REMOTECONFIG_MINIMUM)
@@ -230,8 +454,58 @@ void RemoteConfig::HandleUptime() {
     REMOTECONFIG_DEBUG_ENTRY();
 
     const auto kUptime = timing::UpTime();
-    const auto kLength = snprintf(udp_buffer_, remoteconfig::udp::kBufferSize - 1, "uptime: %us\n", static_cast<unsigned int>(kUptime));
-    network::udp::Send(handle_, reinterpret_cast<const uint8_t*>(udp_buffer_), static_cast<uint32_t>(kLength), ip_from_, remoteconfig::udp::kPort);
+    const auto kLength = snprintf(udp_buffer_, buffer_size_ - 1, "uptime: %us\n", static_cast<unsigned int>(kUptime));
+    Reply(udp_buffer_, static_cast<uint32_t>(kLength));
+
+    REMOTECONFIG_DEBUG_EXIT();
+}
+#endif
+
+#if !defined(CONFIG_REMOTECONFIG_MINIMUM)
+void RemoteConfig::HandleNetStats() {
+    REMOTECONFIG_DEBUG_ENTRY();
+
+    const auto kLength = network::stats::Format(udp_buffer_, buffer_size_);
+    Reply(udp_buffer_, kLength);
+
+    REMOTECONFIG_DEBUG_EXIT();
+}
+#endif
+
+void RemoteConfig::HandleBootTime() {
+    REMOTECONFIG_DEBUG_ENTRY();
+
+    const auto kLength = debug::boottime::Format(udp_buffer_, buffer_size_);
+    Reply(udp_buffer_, kLength);
+
+    REMOTECONFIG_DEBUG_EXIT();
+}
+
+#if defined(CONFIG_DEBUG_TIMELINE)
+/*
+ * The ring does not fit in one datagram, it is sent as a burst of datagrams.
+ * Recording is stopped during the dump and restarts with an empty ring.
+ */
+void RemoteConfig::HandleTimeline() {
+    REMOTECONFIG_DEBUG_ENTRY();
+
+    // It sends its own datagrams, a batch has one reply
+    if (reply_ != nullptr) {
+        Reply("ERROR#?\n", 8);
+        REMOTECONFIG_DEBUG_EXIT();
+        return;
+    }
+
+    debug::timeline::Stop();
+
+    uint32_t index = 0;
+
+    do {
+        const auto kLength = debug::timeline::Format(udp_buffer_, buffer_size_, index);
+        network::udp::Send(handle_, reinterpret_cast<const uint8_t*>(udp_buffer_), kLength, ip_from_, remoteconfig::udp::kPort);
+    } while (!debug::timeline::Done(index));
+
+    debug::timeline::Start();
 
     REMOTECONFIG_DEBUG_EXIT();
 }
@@ -241,8 +515,8 @@ void RemoteConfig::HandleVersion() {
     REMOTECONFIG_DEBUG_ENTRY();
 
     const auto* print = FirmwareVersion::Get()->GetPrint();
-    const auto kLength = snprintf(udp_buffer_, remoteconfig::udp::kBufferSize - 1, "version:%s\n", print);
-    network::udp::Send(handle_, reinterpret_cast<const uint8_t*>(udp_buffer_), static_cast<uint32_t>(kLength), ip_from_, remoteconfig::udp::kPort);
+    const auto kLength = common::format::Snprintf(udp_buffer_, buffer_size_ - 1, "version:%s\n", print);
+    Reply(udp_buffer_, static_cast<uint32_t>(kLength));
 
     REMOTECONFIG_DEBUG_EXIT();
 }
@@ -254,7 +528,7 @@ void RemoteConfig::HandleList() {
 
     auto* list_response = &udp_buffer_[kCmdLength + 2U];
 
-    constexpr auto kListResponseBufferLength = remoteconfig::udp::kBufferSize - (kCmdLength + 2U);
+    const auto kListResponseBufferLength = buffer_size_ - (kCmdLength + 2U);
 
     uint8_t display_name[common::store::remoteconfig::kDisplayNameLength];
 
@@ -284,10 +558,10 @@ void RemoteConfig::HandleList() {
     int list_length;
 
     if (display_name[0] != '\0') {
-        list_length =
-            snprintf(list_response, kListResponseBufferLength, IPSTR ",%s,%s,%u,%s\n", IP2STR(network::GetPrimaryIp()), node_type_name, output_name, static_cast<unsigned>(active_outputs_), reinterpret_cast<const char*>(display_name));
+        list_length = common::format::Snprintf(list_response, kListResponseBufferLength, IPSTR ",%s,%s,%u,%s\n", IP2STR(network::GetPrimaryIp()), node_type_name, output_name, static_cast<unsigned>(active_outputs_),
+                                               reinterpret_cast<const char*>(display_name));
     } else {
-        list_length = snprintf(list_response, kListResponseBufferLength, IPSTR ",%s,%s,%u\n", IP2STR(network::GetPrimaryIp()), node_type_name, output_name, static_cast<unsigned>(active_outputs_));
+        list_length = common::format::Snprintf(list_response, kListResponseBufferLength, IPSTR ",%s,%s,%u\n", IP2STR(network::GetPrimaryIp()), node_type_name, output_name, static_cast<unsigned>(active_outputs_));
     }
 
     if (list_length < 0) {
@@ -297,7 +571,7 @@ void RemoteConfig::HandleList() {
 
     const auto kBytesToSend = static_cast<uint32_t>(std::min<size_t>(static_cast<size_t>(list_length), kListResponseBufferLength - 1U));
 
-    network::udp::Send(handle_, reinterpret_cast<const uint8_t*>(list_response), kBytesToSend, ip_from_, remoteconfig::udp::kPort);
+    Reply(list_response, kBytesToSend);
 
     REMOTECONFIG_DEBUG_EXIT();
 }
@@ -308,11 +582,13 @@ void RemoteConfig::HandleDisplaySet() {
     constexpr auto kCmdLength = kSet[static_cast<uint32_t>(remoteconfig::udp::set::Command::kDisplay)].kLength;
 
     if (bytes_received_ != (kCmdLength + 1U)) {
+        ReplyStatus(false);
         REMOTECONFIG_DEBUG_EXIT();
         return;
     }
 
     Display::Get()->SetSleep(udp_buffer_[kCmdLength + 1U] == '0');
+    ReplyStatus(true);
 
     REMOTECONFIG_DEBUG_PRINTF("%c", udp_buffer_[kCmdLength + 1]);
     REMOTECONFIG_DEBUG_EXIT();
@@ -322,9 +598,9 @@ void RemoteConfig::HandleDisplayGet() {
     REMOTECONFIG_DEBUG_ENTRY();
 
     const bool kIsOn = !(Display::Get()->IsSleep());
-    const auto kLength = snprintf(udp_buffer_, remoteconfig::udp::kBufferSize - 1, "display:%s\n", kIsOn ? "On" : "Off");
+    const auto kLength = snprintf(udp_buffer_, buffer_size_ - 1, "display:%s\n", kIsOn ? "On" : "Off");
 
-    network::udp::Send(handle_, reinterpret_cast<const uint8_t*>(udp_buffer_), static_cast<uint32_t>(kLength), ip_from_, remoteconfig::udp::kPort);
+    Reply(udp_buffer_, static_cast<uint32_t>(kLength));
 
     REMOTECONFIG_DEBUG_EXIT();
 }
@@ -348,6 +624,7 @@ void RemoteConfig::HandleTftpSet() {
     constexpr auto kCmdLength = kSet[static_cast<uint32_t>(remoteconfig::udp::set::Command::kTftp)].kLength;
 
     if (bytes_received_ != (kCmdLength + 1U)) {
+        ReplyStatus(false);
         REMOTECONFIG_DEBUG_EXIT();
         return;
     }
@@ -359,6 +636,7 @@ void RemoteConfig::HandleTftpSet() {
     }
 
     PlatformHandleTftpSet();
+    ReplyStatus(true);
 
     REMOTECONFIG_DEBUG_EXIT();
 }
@@ -368,8 +646,8 @@ void RemoteConfig::HandleTftpGet() {
 
     PlatformHandleTftpGet();
 
-    const auto kLength = snprintf(udp_buffer_, remoteconfig::udp::kBufferSize - 1, "tftp:%s\n", enable_tftp_ ? "On" : "Off");
-    network::udp::Send(handle_, reinterpret_cast<const uint8_t*>(udp_buffer_), static_cast<uint32_t>(kLength), ip_from_, remoteconfig::udp::kPort);
+    const auto kLength = snprintf(udp_buffer_, buffer_size_ - 1, "tftp:%s\n", enable_tftp_ ? "On" : "Off");
+    Reply(udp_buffer_, static_cast<uint32_t>(kLength));
 
     REMOTECONFIG_DEBUG_EXIT();
 }
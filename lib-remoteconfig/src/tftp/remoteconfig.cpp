@@ -32,16 +32,17 @@
 #include "flashcodeinstall.h"
 #include "firmware.h"
 #include "display.h"
+#include "common/utils/utils_inplace.h"
 #include "firmware/debug/debug_debug.h"
 
-static uint8_t s_tftp_buffer[FIRMWARE_MAX_SIZE];
+alignas(4) static uint8_t s_tftp_buffer[FIRMWARE_MAX_SIZE];
+static common::InPlace<TFTPFileServer> s_tftp_file_server;
 
 void RemoteConfig::PlatformHandleTftpSet() {
     REMOTECONFIG_DEBUG_ENTRY();
 
     if (enable_tftp_ && (tftp_file_server_ == nullptr)) {
-        tftp_file_server_ = new TFTPFileServer(s_tftp_buffer, FIRMWARE_MAX_SIZE);
-        assert(m_pTFTPFileServer != nullptr);
+        tftp_file_server_ = s_tftp_file_server.Emplace(s_tftp_buffer, static_cast<uint32_t>(FIRMWARE_MAX_SIZE));
         Display::Get()->TextStatus("TFTP On", ansi::Colours::Colour::kGreen);
     } else if (!enable_tftp_ && (tftp_file_server_ != nullptr)) {
         const uint32_t kFileSize = tftp_file_server_->GetFileSize();
@@ -57,7 +58,7 @@ void RemoteConfig::PlatformHandleTftpSet() {
             }
         }
 
-        delete tftp_file_server_;
+        s_tftp_file_server.Reset();
         tftp_file_server_ = nullptr;
 
         if (succes) { // Keep error message
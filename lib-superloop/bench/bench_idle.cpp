@@ -0,0 +1,191 @@
+/**
+ * @file bench_idle.cpp
+ *
+ * Host-side loop-latency benchmark for the event-driven superloop.
+ *
+ * Simulates 60 s of the bootloader main loop with the real software timers:
+ * - Ethernet frames arrive Poisson distributed, 50 frames/s;
+ * - three software timers at 20, 100 and 1000 ms;
+ * - one idle loop iteration costs 3 us, servicing a frame 20 us.
+ * The WFI wakes on the 1 kHz SysTick or on the ENET RX interrupt.
+ *
+ * Reported: the share of time the core is awake, the number of wake-ups and
+ * the latency from frame arrival / timer due time to its handling.
+ */
+/* Copyright (C) 2026 by Arjan van Vught mailto:info@gd32-dmx.org
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "softwaretimers.h"
+#include "superloop_event.h"
+#include "timing.h"
+
+namespace sim {
+uint64_t g_micros;
+} // namespace sim
+
+namespace {
+constexpr uint64_t kRunMicros = 60000000;
+constexpr uint64_t kIterationMicros = 3;
+constexpr uint64_t kFrameMicros = 20;
+constexpr uint64_t kWakeUpMicros = 1;
+constexpr double kFramesPerSecond = 50;
+
+struct Periodic {
+    uint32_t interval_millis;
+    uint64_t due;
+};
+
+Periodic s_periodic[] = {{20, 0}, {100, 0}, {1000, 0}};
+
+std::vector<uint64_t> s_frames;
+size_t s_frame_next;
+std::vector<uint64_t> s_latency_rx;
+std::vector<uint64_t> s_latency_timer;
+uint64_t s_awake_micros;
+uint64_t s_wake_ups;
+
+void OnTimer(size_t index) {
+    auto& periodic = s_periodic[index];
+    s_latency_timer.push_back(sim::g_micros - periodic.due);
+    periodic.due = (sim::g_micros / 1000) * 1000 + periodic.interval_millis * 1000ULL;
+}
+
+void Timer0([[maybe_unused]] TimerHandle_t handle) {
+    OnTimer(0);
+}
+
+void Timer1([[maybe_unused]] TimerHandle_t handle) {
+    OnTimer(1);
+}
+
+void Timer2([[maybe_unused]] TimerHandle_t handle) {
+    OnTimer(2);
+}
+
+// ENET RX interrupt for every frame arriving in (from, to]
+void Interrupts(uint64_t from, uint64_t to) {
+    for (auto i = s_frame_next; i < s_frames.size() && s_frames[i] <= to; i++) {
+        if (s_frames[i] > from) {
+            superloop::event::Set(superloop::event::kNetwork);
+        }
+    }
+}
+
+void Advance(uint64_t micros) {
+    Interrupts(sim::g_micros, sim::g_micros + micros);
+    sim::g_micros += micros;
+    s_awake_micros += micros;
+}
+
+void NetworkRun() {
+    while (s_frame_next < s_frames.size() && s_frames[s_frame_next] <= sim::g_micros) {
+        s_latency_rx.push_back(sim::g_micros - s_frames[s_frame_next]);
+        s_frame_next++;
+        Advance(kFrameMicros);
+    }
+}
+
+// Sleep until the next SysTick or the next frame
+void Wfi() {
+    auto next = (sim::g_micros / 1000 + 1) * 1000;
+
+    if (s_frame_next < s_frames.size() && s_frames[s_frame_next] > sim::g_micros && s_frames[s_frame_next] < next) {
+        next = s_frames[s_frame_next] + kWakeUpMicros;
+    }
+
+    Interrupts(sim::g_micros, next);
+    sim::g_micros = next;
+    s_awake_micros += kWakeUpMicros;
+    s_wake_ups++;
+}
+
+// Mirrors board::Idle() in gd32_board.h
+void Idle() {
+    const auto kDeadline = timing::Millis() + SoftwareTimerNextExpire(superloop::event::kIdleMillisMax);
+
+    while ((superloop::event::global::flags == 0) && (static_cast<int32_t>(timing::Millis() - kDeadline) < 0)) {
+        Wfi();
+    }
+
+    superloop::event::global::flags = 0;
+}
+
+void Report(const char* name, std::vector<uint64_t>& latency) {
+    std::sort(latency.begin(), latency.end());
+    printf("  %-6s n=%-6zu p50=%-3llu p99=%-3llu max=%llu us\n", name, latency.size(), static_cast<unsigned long long>(latency[latency.size() / 2]),
+           static_cast<unsigned long long>(latency[latency.size() * 99 / 100]), static_cast<unsigned long long>(latency.back()));
+}
+
+void Run(bool event_driven) {
+    std::mt19937 generator(1);
+    std::exponential_distribution<double> distribution(kFramesPerSecond / 1e6);
+
+    s_frames.clear();
+    for (auto t = 1000.0; t < static_cast<double>(kRunMicros); t += distribution(generator)) {
+        s_frames.push_back(static_cast<uint64_t>(t));
+    }
+
+    s_frame_next = 0;
+    s_latency_rx.clear();
+    s_latency_timer.clear();
+    s_awake_micros = 0;
+    s_wake_ups = 0;
+    sim::g_micros = 0;
+    superloop::event::global::flags = 0;
+
+    TimerHandle_t handles[] = {SoftwareTimerAdd(s_periodic[0].interval_millis, Timer0), SoftwareTimerAdd(s_periodic[1].interval_millis, Timer1),
+                               SoftwareTimerAdd(s_periodic[2].interval_millis, Timer2)};
+
+    for (auto& periodic : s_periodic) {
+        periodic.due = periodic.interval_millis * 1000ULL;
+    }
+
+    while (sim::g_micros < kRunMicros) {
+        Advance(kIterationMicros);
+        NetworkRun();
+        SoftwareTimerRun();
+        if (event_driven) {
+            Idle();
+        }
+    }
+
+    printf("%s: awake %.2f%%, wake-ups %llu\n", event_driven ? "event-driven (WFI)" : "busy polling",
+           100.0 * static_cast<double>(s_awake_micros) / static_cast<double>(kRunMicros), static_cast<unsigned long long>(s_wake_ups));
+    Report("rx", s_latency_rx);
+    Report("timer", s_latency_timer);
+
+    for (auto& handle : handles) {
+        SoftwareTimerDelete(handle);
+    }
+}
+} // namespace
+
+int main() {
+    Run(false);
+    Run(true);
+    return 0;
+}
@@ -0,0 +1,19 @@
+/**
+ * @file ansi_colour.h
+ *
+ * Host stub.
+ */
+
+#ifndef ANSI_COLOUR_H_
+#define ANSI_COLOUR_H_
+
+namespace ansi {
+struct Colours {
+    struct Fg {
+        static constexpr const char* kRed = "";
+        static constexpr const char* kDefault = "";
+    };
+};
+} // namespace ansi
+
+#endif // ANSI_COLOUR_H_
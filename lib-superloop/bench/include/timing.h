@@ -0,0 +1,26 @@
+/**
+ * @file timing.h
+ *
+ * Host stub: the clock is driven by the simulation.
+ */
+
+#ifndef TIMING_H_
+#define TIMING_H_
+
+#include <cstdint>
+
+namespace sim {
+extern uint64_t g_micros;
+} // namespace sim
+
+namespace timing {
+inline uint32_t Millis() {
+    return static_cast<uint32_t>(sim::g_micros / 1000);
+}
+
+inline uint32_t Micros() {
+    return static_cast<uint32_t>(sim::g_micros);
+}
+} // namespace timing
+
+#endif // TIMING_H_
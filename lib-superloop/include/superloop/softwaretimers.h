@@ -45,5 +45,6 @@ bool SoftwareTimerDelete(TimerHandle_t& handle);
 bool SoftwareTimerChange(TimerHandle_t handle, uint32_t interval_millis);
 
 void SoftwareTimerRun();
+uint32_t SoftwareTimerNextExpire(uint32_t millis_max);
 
 #endif  // SUPERLOOP_SOFTWARETIMERS_H_
@@ -0,0 +1,58 @@
+/**
+ * @file superloop_event.h
+ *
+ */
+/* Copyright (C) 2026 by Arjan van Vught mailto:info@gd32-dmx.org
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef SUPERLOOP_SUPERLOOP_EVENT_H_
+#define SUPERLOOP_SUPERLOOP_EVENT_H_
+
+#include <cstdint>
+
+/*
+ * Event flags for the event-driven superloop (CONFIG_SUPERLOOP_EVENT_DRIVEN).
+ * Interrupt handlers set a flag, the main loop sleeps when none is pending
+ * and no software timer is due. Set() must only be called from an interrupt
+ * handler, the main loop clears the flags with interrupts disabled.
+ */
+namespace superloop::event {
+inline constexpr uint32_t kNetwork = (1U << 0);
+inline constexpr uint32_t kPeripheral = (1U << 1);
+
+// Upper bound for a sleep, for code that still polls timing::Millis()
+inline constexpr uint32_t kIdleMillisMax =
+#if defined(CONFIG_SUPERLOOP_IDLE_MILLIS_MAX)
+    CONFIG_SUPERLOOP_IDLE_MILLIS_MAX;
+#else
+    10;
+#endif
+
+namespace global {
+inline volatile uint32_t flags;
+} // namespace global
+
+inline void Set(uint32_t event) {
+    global::flags = global::flags | event;
+}
+} // namespace superloop::event
+
+#endif // SUPERLOOP_SUPERLOOP_EVENT_H_
@@ -200,8 +200,11 @@ void SoftwareTimerRun() {
 
         callback_function(kId);
 
-        // reschedule from NOW to avoid pile-ups after delays
-        s_timers[s_timer_current].expire_time = kNow + kInterval;
+        // The callback may have deleted its own timer, the slot then holds another one
+        if ((s_timer_current < s_timers_count) && (s_timers[s_timer_current].id == kId)) {
+            // reschedule from NOW to avoid pile-ups after delays
+            s_timers[s_timer_current].expire_time = kNow + kInterval;
+        }
     }
 
     // Advance round-robin cursor (bounded next call).
@@ -210,3 +213,28 @@ void SoftwareTimerRun() {
         s_timer_current = 0;
     }
 }
+
+/**
+ * @brief Time until the first timer expires, used by the event-driven superloop.
+ *
+ * @param millis_max Upper bound, also returned when there are no timers.
+ * @return Milliseconds until the next expiry, 0 when a timer has already expired.
+ */
+uint32_t SoftwareTimerNextExpire(uint32_t millis_max) {
+    const uint32_t kNow = timing::Millis();
+    auto next = millis_max;
+
+    for (uint32_t i = 0; i < s_timers_count; ++i) {
+        const auto kRemaining = static_cast<int32_t>(s_timers[i].expire_time - kNow);
+
+        if (kRemaining <= 0) {
+            return 0;
+        }
+
+        if (static_cast<uint32_t>(kRemaining) < next) {
+            next = static_cast<uint32_t>(kRemaining);
+        }
+    }
+
+    return next;
+}